@@ -0,0 +1,106 @@
+#ifndef ALIGNEDBUFFER_H
+#define ALIGNEDBUFFER_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+/**
+ * @brief A single heap allocation of trivially copyable values, aligned to a
+ * cache line so rows of it can be loaded with aligned vector instructions.
+ * Unlike std::vector, resizing does not initialise or keep the values.
+ *
+ * @tparam T Value type, e.g. float or std::complex<float>
+ */
+template <typename T>
+class AlignedBuffer {
+    public:
+        // alignment in bytes of the first value
+        static const size_t alignment = 64;
+
+        AlignedBuffer() : raw(0), values(0), count(0) {}
+
+        /**
+         * @brief Construct a new AlignedBuffer object of count uninitialised values
+         *
+         * @param count
+         */
+        explicit AlignedBuffer(size_t count) : raw(0), values(0), count(0) {
+            AlignedBuffer::resize(count);
+        }
+
+        AlignedBuffer(const AlignedBuffer &other) : raw(0), values(0), count(0) {
+            AlignedBuffer::resize(other.count);
+            if (other.count > 0) {
+                std::memcpy((void*) AlignedBuffer::values, (const void*) other.values, other.count * sizeof(T));
+            } // if
+        }
+
+        AlignedBuffer(AlignedBuffer &&other) : raw(other.raw), values(other.values), count(other.count) {
+            other.raw = 0;
+            other.values = 0;
+            other.count = 0;
+        }
+
+        AlignedBuffer &operator=(AlignedBuffer other) {
+            std::swap(AlignedBuffer::raw, other.raw);
+            std::swap(AlignedBuffer::values, other.values);
+            std::swap(AlignedBuffer::count, other.count);
+            return *this;
+        }
+
+        ~AlignedBuffer() {
+            delete[] AlignedBuffer::raw;
+        }
+
+        /**
+         * @brief Reallocates the buffer for count values if the size changes.
+         * The values are left uninitialised.
+         *
+         * @param count
+         */
+        void resize(size_t count) {
+            if (count == AlignedBuffer::count) {
+                return;
+            } // if
+
+            delete[] AlignedBuffer::raw;
+            AlignedBuffer::raw = 0;
+            AlignedBuffer::values = 0;
+            AlignedBuffer::count = count;
+
+            if (count > 0) {
+                // over allocate, and start at the first aligned address
+                AlignedBuffer::raw = new char[count * sizeof(T) + alignment];
+                uintptr_t address = (uintptr_t) AlignedBuffer::raw;
+                address = (address + alignment - 1) & ~(uintptr_t) (alignment - 1);
+                AlignedBuffer::values = (T*) address;
+            } // if
+        }
+
+        /**
+         * @brief Sets every value
+         *
+         * @param value
+         */
+        void fill(const T &value) {
+            std::fill(AlignedBuffer::values, AlignedBuffer::values + AlignedBuffer::count, value);
+        }
+
+        size_t size() const { return AlignedBuffer::count; }
+        bool empty() const { return AlignedBuffer::count == 0; }
+
+        T *data() { return AlignedBuffer::values; }
+        const T *data() const { return AlignedBuffer::values; }
+
+        T &operator[](size_t i) { return AlignedBuffer::values[i]; }
+        const T &operator[](size_t i) const { return AlignedBuffer::values[i]; }
+
+    private:
+        char *raw;
+        T *values;
+        size_t count;
+};
+
+#endif // ALIGNEDBUFFER_H
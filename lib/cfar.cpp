@@ -0,0 +1,213 @@
+#include <complex>
+#include <cmath>
+#include <algorithm>
+#include <set>
+#include <stdexcept>
+#include "cfar.h"
+
+using namespace std;
+
+namespace {
+
+// false alarm rate of threshold factor t on the rank-th smallest of n cells
+double orderedPfa(int n, int rank, double t) {
+    double pfa = 1;
+    for (int i = 0; i < rank; i++) {
+        pfa *= (n - i) / (n - i + t);
+    } // for
+
+    return pfa;
+}
+
+// adds a cell to the sorted window, keeping rank as the rank (from 1) of kth
+void enter(std::multiset<float> &window, std::multiset<float>::iterator &kth, int &rank, float value) {
+    // equal values go after those already in the window
+    std::multiset<float>::iterator pos = window.insert(value);
+    if (rank == 0) {
+        kth = pos;
+        rank = 1;
+    } else if (value < *kth) {
+        rank++;
+    } // else if
+}
+
+// removes a cell from the sorted window, keeping rank as the rank of kth
+void leave(std::multiset<float> &window, std::multiset<float>::iterator &kth, int &rank, float value) {
+    if (value != *kth) {
+        if (value < *kth) {
+            rank--;
+        } // if
+        window.erase(window.find(value));
+        return;
+    } // if
+
+    // kth itself leaves, so it moves to a neighbour first
+    std::multiset<float>::iterator victim = kth;
+    if (std::next(kth) != window.end()) {
+        ++kth;
+    } else if (rank > 1) {
+        --kth;
+        rank--;
+    } else {
+        rank = 0;
+    } // else
+    window.erase(victim);
+}
+
+} // namespace
+
+Cfar::Cfar(const std::vector<float> &freqBins, int guardCells, int refCells, double pfa, Method method, int rank) :
+freqBins(freqBins), guardCells(guardCells), refCells(refCells), method(method) {
+    if (guardCells < 0 || refCells <= 0) {
+        throw std::invalid_argument("Cfar: there must be at least one reference cell and no negative guard cells");
+    } // if
+    if (pfa <= 0 || pfa >= 1) {
+        throw std::invalid_argument("Cfar: the false alarm rate must be between 0 and 1");
+    } // if
+
+    Cfar::rank = rank > 0 ? std::min(rank, 2 * refCells) : std::max(1, 3 * refCells / 2);
+
+    Cfar::factors.assign(2 * refCells + 1, 0);
+    for (int n = 1; n <= 2 * refCells; n++) {
+        if (method == CELL_AVERAGING) {
+            Cfar::factors[n] = n * (pow(pfa, -1.0 / n) - 1);
+        } else {
+            // the rate falls as the factor grows, so bracket it and bisect
+            int k = Cfar::rankFor(n);
+            double low = 0;
+            double high = 1;
+            while (orderedPfa(n, k, high) > pfa) {
+                high *= 2;
+            } // while
+            for (int i = 0; i < 100; i++) {
+                double mid = (low + high) / 2;
+                if (orderedPfa(n, k, mid) > pfa) {
+                    low = mid;
+                } else {
+                    high = mid;
+                } // else
+            } // for
+            Cfar::factors[n] = high;
+        } // else
+    } // for
+}
+
+Cfar::~Cfar() { }
+
+void Cfar::detect(const std::complex<float> *spectrum, int bins, std::vector<Detection> &detections, int frame) const {
+    std::vector<float> power;
+    Cfar::detect(spectrum, bins, detections, frame, power);
+}
+
+std::vector<std::vector<Detection>> Cfar::detect(const Spectrogram<std::complex<float>> &spectrogram) const {
+    std::vector<std::vector<Detection>> res(spectrogram.getFrameCount());
+    std::vector<float> power;
+
+    for (int i = 0; i < spectrogram.getFrameCount(); i++) {
+        Cfar::detect(spectrogram.row(i).data(), spectrogram.getBinCount(), res[i], i, power);
+    } // for
+
+    return res;
+}
+
+void Cfar::detect(const std::complex<float> *spectrum, int bins, std::vector<Detection> &detections, int frame,
+    std::vector<float> &power) const {
+    detections.clear();
+    bins = std::min(bins, (int) Cfar::freqBins.size());
+    if (bins <= 0) {
+        return;
+    } // if
+
+    power.resize(bins);
+    for (int j = 0; j < bins; j++) {
+        power[j] = spectrum[j].real() * spectrum[j].real() + spectrum[j].imag() * spectrum[j].imag();
+    } // for
+
+    int guard = Cfar::guardCells;
+    int ref = Cfar::refCells;
+    bool averaging = Cfar::method == CELL_AVERAGING;
+
+    // the ordered statistic window is kept sorted, with an iterator on the
+    // order statistic that steps as cells enter and leave, so each bin costs
+    // O(log refCells) rather than a move of the whole window
+    std::multiset<float> window;
+    std::multiset<float>::iterator kth = window.end();
+    int kthRank = 0;
+
+    // reference cells of bin 0, which only has the right hand side
+    double sum = 0;
+    int count = 0;
+    for (int i = guard + 1; i <= guard + ref && i < bins; i++) {
+        sum += power[i];
+        count++;
+        if (!averaging) {
+            enter(window, kth, kthRank, power[i]);
+        } // if
+    } // for
+
+    for (int j = 0; j < bins; j++) {
+        if (j > 0) {
+            // slide both sides of the window one bin to the right
+            int leftIn = j - guard - 1;
+            int leftOut = j - guard - ref - 1;
+            int rightOut = j + guard;
+            int rightIn = j + guard + ref;
+
+            int out[2] = {leftOut, rightOut};
+            int in[2] = {leftIn, rightIn};
+            for (int s = 0; s < 2; s++) {
+                if (out[s] >= 0 && out[s] < bins) {
+                    sum -= power[out[s]];
+                    count--;
+                    if (!averaging) {
+                        leave(window, kth, kthRank, power[out[s]]);
+                    } // if
+                } // if
+                if (in[s] >= 0 && in[s] < bins) {
+                    sum += power[in[s]];
+                    count++;
+                    if (!averaging) {
+                        enter(window, kth, kthRank, power[in[s]]);
+                    } // if
+                } // if
+            } // for
+        } // if
+
+        float cell = power[j];
+        if (count <= 0 || (j > 0 && cell < power[j - 1]) || (j + 1 < bins && cell < power[j + 1])) {
+            continue;
+        } // if
+
+        if (!averaging) {
+            // the rank follows the number of cells, which changes by at most two
+            int target = Cfar::rankFor(count);
+            for (; kthRank < target; kthRank++) {
+                ++kth;
+            } // for
+            for (; kthRank > target; kthRank--) {
+                --kth;
+            } // for
+        } // if
+
+        double noise = averaging ? sum / count : *kth;
+        if (noise <= 0 || cell <= Cfar::factors[count] * noise) {
+            continue;
+        } // if
+
+        Detection detection = {frame, j, Cfar::freqBins[j], cell, (float) (10 * log10(cell / noise))};
+        detections.push_back(detection);
+    } // for
+}
+
+double Cfar::getThresholdFactor() const {
+    return Cfar::factors[2 * Cfar::refCells];
+}
+
+Cfar::Method Cfar::getMethod() const {
+    return Cfar::method;
+}
+
+int Cfar::rankFor(int count) const {
+    int k = (int) std::floor((double) Cfar::rank * count / (2 * Cfar::refCells) + 0.5);
+    return std::max(1, std::min(count, k));
+}
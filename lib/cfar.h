@@ -0,0 +1,107 @@
+#ifndef CFAR_H
+#define CFAR_H
+
+#include <complex>
+#include <vector>
+#include "spectrogram.h"
+
+/**
+ * @brief A cell of a spectrogram that stands out of its noise
+ */
+struct Detection {
+    int frame;
+    int bin;
+    // frequency of the bin (Hz)
+    float freq;
+    // squared magnitude of the cell
+    float power;
+    // ratio of the power to the noise estimate (dB)
+    float snr;
+};
+
+class Cfar {
+    public:
+        /**
+         * @brief Ways of estimating the noise around a cell. CELL_AVERAGING takes
+         * the mean of the reference cells, which is best in uniform noise.
+         * ORDERED_STATISTIC takes one of their order statistics, so a second
+         * target among the reference cells does not mask the first.
+         */
+        enum Method {CELL_AVERAGING, ORDERED_STATISTIC};
+
+        /**
+         * @brief Construct a new Cfar object, a constant false alarm rate detector
+         * for the bins of each spectrogram frame. The noise around a cell is
+         * estimated from refCells bins either side of it, beyond guardCells bins
+         * that keep the target's own leakage out, and the cell is detected if its
+         * power exceeds the estimate by a factor chosen for a false alarm rate of
+         * pfa in exponentially distributed (square law detected) noise. The
+         * reference window slides one bin at a time, so the cost per bin does not
+         * grow with refCells for cell averaging, and grows as log(refCells) for
+         * ordered statistic, whose window is kept sorted. Only cells that are also local maxima are
+         * reported, so a target spread over a main lobe gives one detection.
+         *
+         * @param freqBins Frequency of each bin (Hz), as given by STFT::getFreqBins
+         * @param guardCells Number of bins either side of a cell left out of the noise estimate
+         * @param refCells Number of bins either side of the guard cells the noise is estimated from
+         * @param pfa Probability of a false alarm per cell
+         * @param method Noise estimate
+         * @param rank For ORDERED_STATISTIC, the order statistic (from 1, smallest) of
+         * the 2*refCells reference cells to use. Defaults to 3/4 of them.
+         */
+        Cfar(const std::vector<float> &freqBins, int guardCells, int refCells, double pfa=1e-6, Method method=CELL_AVERAGING, int rank=0);
+
+        ~Cfar();
+
+        /**
+         * @brief Detects the targets of one frame, in order of bin
+         *
+         * @param spectrum bins values of the frame
+         * @param bins Number of bins, at most the number of frequency bins
+         * @param detections Replaced with the detections
+         * @param frame Frame index to record in the detections
+         */
+        void detect(const std::complex<float> *spectrum, int bins, std::vector<Detection> &detections, int frame=0) const;
+
+        /**
+         * @brief Detects the targets of each frame of a spectrogram
+         *
+         * @param spectrogram
+         * @return std::vector<std::vector<Detection>> with one row per frame
+         */
+        std::vector<std::vector<Detection>> detect(const Spectrogram<std::complex<float>> &spectrogram) const;
+
+        /**
+         * @brief Gets the factor the noise estimate is scaled by to give the
+         * threshold, when all 2*refCells reference cells are available
+         *
+         * @return double
+         */
+        double getThresholdFactor() const;
+
+        /**
+         * @brief Gets the noise estimate
+         *
+         * @return Method
+         */
+        Method getMethod() const;
+
+    private:
+        void detect(const std::complex<float> *spectrum, int bins, std::vector<Detection> &detections, int frame,
+            std::vector<float> &power) const;
+
+        // order statistic used for a window of count cells
+        int rankFor(int count) const;
+
+        std::vector<float> freqBins;
+        int guardCells;
+        int refCells;
+        Method method;
+        int rank;
+
+        // threshold factor for each number of reference cells, which is
+        // smaller at the ends of the frame
+        std::vector<double> factors;
+};
+
+#endif // CFAR_H
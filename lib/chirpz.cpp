@@ -0,0 +1,101 @@
+#include <complex>
+#include <cmath>
+#include <algorithm>
+#include <stdexcept>
+#include "chirpz.h"
+#include "simd.h"
+
+using namespace std;
+
+namespace {
+
+std::complex<float> unit(double angle) {
+    return std::complex<float>((float) cos(angle), (float) sin(angle));
+}
+
+} // namespace
+
+ChirpZ::ChirpZ(int len, int bins, double fStart, double fEnd, int samplingFreq) :
+len(len), bins(bins) {
+    if (len <= 0 || bins <= 0 || samplingFreq <= 0) {
+        throw std::invalid_argument("ChirpZ: the lengths and the sampling frequency must be positive");
+    } // if
+
+    // W = e^(-j step) for a step between frequencies of step rad/sample
+    double step = bins > 1 ? 2 * M_PI * (fEnd - fStart) / ((double) samplingFreq * (bins - 1)) : 0;
+    double start = 2 * M_PI * fStart / samplingFreq;
+
+    for (int k = 0; k < bins; k++) {
+        ChirpZ::freqBins.push_back((float) (fStart + (bins > 1 ? k * (fEnd - fStart) / (bins - 1) : 0)));
+    } // for
+
+    int convLen = 1;
+    while (convLen < len + bins - 1) {
+        convLen *= 2;
+    } // while
+    ChirpZ::plan = std::make_shared<FFTPlan>(convLen);
+
+    // n k = (n^2 + k^2 - (k - n)^2) / 2 turns the sum into a convolution
+    ChirpZ::pre.resize(len);
+    for (int n = 0; n < len; n++) {
+        ChirpZ::pre[n] = unit(-start * n - step * ((double) n * n) / 2);
+    } // for
+
+    ChirpZ::post.resize(bins);
+    for (int k = 0; k < bins; k++) {
+        ChirpZ::post[k] = unit(-step * ((double) k * k) / 2);
+    } // for
+
+    // the chirp is needed for lags -(len - 1) to bins - 1, and negative lags wrap around
+    ChirpZ::chirpSpectrum.assign(convLen, std::complex<float>(0, 0));
+    float scale = 1.0f / convLen;
+    for (int m = 0; m < bins; m++) {
+        ChirpZ::chirpSpectrum[m] = unit(step * ((double) m * m) / 2) * scale;
+    } // for
+    for (int m = 1; m < len; m++) {
+        ChirpZ::chirpSpectrum[convLen - m] = unit(step * ((double) m * m) / 2) * scale;
+    } // for
+    ChirpZ::plan->execute(&ChirpZ::chirpSpectrum[0]);
+
+    ChirpZ::work.resize(convLen);
+}
+
+ChirpZ::~ChirpZ() { }
+
+void ChirpZ::execute(const std::complex<float> *input, std::complex<float> *output) const {
+    int convLen = ChirpZ::plan->getFFTLen();
+    std::complex<float> *work = &ChirpZ::work[0];
+
+    // the tail holds the previous convolution, so it is zero padded again
+    Simd::complexMultiply(input, &ChirpZ::pre[0], work, ChirpZ::len);
+    std::fill(work + ChirpZ::len, work + convLen, std::complex<float>(0, 0));
+
+    ChirpZ::plan->execute(work);
+    Simd::complexMultiply(work, &ChirpZ::chirpSpectrum[0], work, convLen);
+    ChirpZ::plan->executeInverse(work);
+
+    Simd::complexMultiply(work, &ChirpZ::post[0], output, ChirpZ::bins);
+}
+
+std::vector<std::complex<float>> ChirpZ::execute(const std::vector<std::complex<float>> &input) const {
+    if (input.size() != ChirpZ::len) {
+        throw std::invalid_argument("ChirpZ: the input must have len samples");
+    } // if
+
+    std::vector<std::complex<float>> output(ChirpZ::bins);
+    ChirpZ::execute(&input[0], &output[0]);
+
+    return output;
+}
+
+int ChirpZ::getLen() const {
+    return ChirpZ::len;
+}
+
+int ChirpZ::getBinCount() const {
+    return ChirpZ::bins;
+}
+
+std::vector<float> ChirpZ::getFreqBins() const {
+    return ChirpZ::freqBins;
+}
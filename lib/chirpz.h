@@ -0,0 +1,84 @@
+#ifndef CHIRPZ_H
+#define CHIRPZ_H
+
+#include <complex>
+#include <memory>
+#include <vector>
+#include "fftplan.h"
+
+class ChirpZ {
+    public:
+        /**
+         * @brief Construct a new ChirpZ object, a zoom FFT that evaluates the spectrum
+         * of len samples at bins evenly spaced frequencies from fStart to fEnd, so
+         * the bin spacing is independent of len. The sum is rewritten as a
+         * convolution with a chirp (Bluestein), which costs two FFTs of a
+         * power of two of at least len + bins - 1 points, whatever the range.
+         * The power of two FFT plan keeps no state, but execute() works in a
+         * buffer of the object, allocated once here, so one object must not be
+         * executed from several threads at once.
+         *
+         * @param len Number of input samples
+         * @param bins Number of output frequencies
+         * @param fStart First frequency (Hz)
+         * @param fEnd Last frequency (Hz)
+         * @param samplingFreq Sampling frequency (Hz)
+         */
+        ChirpZ(int len, int bins, double fStart, double fEnd, int samplingFreq);
+
+        ~ChirpZ();
+
+        /**
+         * @brief Evaluates the spectrum, X(f) = sum_n x[n] e^(-j 2 pi f n / fs)
+         *
+         * @param input len samples
+         * @param output bins values, one per frequency
+         */
+        void execute(const std::complex<float> *input, std::complex<float> *output) const;
+
+        /**
+         * @brief Evaluates the spectrum, X(f) = sum_n x[n] e^(-j 2 pi f n / fs)
+         *
+         * @param input len samples
+         * @return std::vector<std::complex<float>> of bins values
+         */
+        std::vector<std::complex<float>> execute(const std::vector<std::complex<float>> &input) const;
+
+        /**
+         * @brief Gets the number of input samples
+         *
+         * @return int
+         */
+        int getLen() const;
+
+        /**
+         * @brief Gets the number of output frequencies
+         *
+         * @return int
+         */
+        int getBinCount() const;
+
+        /**
+         * @brief Get the frequency of each output (Hz)
+         *
+         * @return std::vector<float>
+         */
+        std::vector<float> getFreqBins() const;
+
+    private:
+        int len;
+        int bins;
+        std::vector<float> freqBins;
+
+        std::shared_ptr<FFTPlan> plan;
+        // e^(-j 2 pi fStart n / fs) W^(n^2 / 2), applied to the input
+        std::vector<std::complex<float>> pre;
+        // W^(k^2 / 2), applied to the output
+        std::vector<std::complex<float>> post;
+        // spectrum of the chirp W^(-m^2 / 2), scaled by 1/convLen
+        std::vector<std::complex<float>> chirpSpectrum;
+        // convolution of the weighted input with the chirp
+        mutable std::vector<std::complex<float>> work;
+};
+
+#endif // CHIRPZ_H
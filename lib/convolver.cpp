@@ -0,0 +1,177 @@
+#include <complex>
+#include <cmath>
+#include <algorithm>
+#include <stdexcept>
+#include "convolver.h"
+#include "simd.h"
+
+using namespace std;
+
+Convolver::Convolver(const std::vector<std::complex<float>> &filter, Method method, int fftLen) :
+filter(filter), method(method), fftLen(0) {
+    if (filter.empty()) {
+        throw std::invalid_argument("Convolver: the filter is empty");
+    } // if
+
+    int len = filter.size();
+
+    if (Convolver::method == AUTO) {
+        Convolver::method = len <= Convolver::directMaxLen ? DIRECT : OVERLAP_SAVE;
+    } // if
+
+    if (Convolver::method == DIRECT) {
+        return;
+    } // if
+
+    if (fftLen > 0) {
+        if ((fftLen & (fftLen - 1)) != 0 || fftLen < 2 * len) {
+            throw std::invalid_argument("Convolver: the FFT length must be a power of two of at least twice the filter length");
+        } // if
+        Convolver::fftLen = fftLen;
+    } else {
+        // each block of n costs about n*log2(n) and yields n - len + 1 outputs
+        int n = 2;
+        while (n < 2 * len) {
+            n *= 2;
+        } // while
+
+        double best = 0;
+        for (int bits = (int) std::log2(n); bits <= 20; bits++, n *= 2) {
+            double cost = n * (double) bits / (n - len + 1);
+            if (Convolver::fftLen == 0 || cost < best) {
+                best = cost;
+                Convolver::fftLen = n;
+            } // if
+        } // for
+    } // else
+
+    Convolver::plan = std::make_shared<FFTPlan>(Convolver::fftLen);
+
+    Convolver::spectrum.assign(Convolver::fftLen, std::complex<float>(0, 0));
+    float scale = 1.0f / Convolver::fftLen;
+    for (int i = 0; i < len; i++) {
+        Convolver::spectrum[i] = filter[i] * scale;
+    } // for
+    Convolver::plan->execute(&Convolver::spectrum[0]);
+}
+
+Convolver::~Convolver() { }
+
+const std::vector<std::complex<float>> &Convolver::getFilter() const {
+    return Convolver::filter;
+}
+
+Convolver::Method Convolver::getMethod() const {
+    return Convolver::method;
+}
+
+int Convolver::getFFTLen() const {
+    return Convolver::fftLen;
+}
+
+std::vector<std::complex<float>> Convolver::convolve(const std::vector<std::complex<float>> &seq) const {
+    if (seq.empty()) {
+        return std::vector<std::complex<float>>();
+    } // if
+
+    std::vector<std::complex<float>> output(seq.size() + Convolver::filter.size() - 1);
+    Convolver::convolve(&seq[0], seq.size(), &output[0]);
+
+    return output;
+}
+
+void Convolver::convolve(const std::complex<float> *seq, int seqLen, std::complex<float> *output) const {
+    if (seqLen <= 0) {
+        return;
+    } // if
+
+    switch (Convolver::method) {
+        case OVERLAP_ADD:
+            Convolver::overlapAdd(seq, seqLen, output);
+            break;
+        case OVERLAP_SAVE:
+            Convolver::overlapSave(seq, seqLen, output);
+            break;
+        default:
+            Convolver::convolveDirect(seq, seqLen, output);
+            break;
+    } // switch
+}
+
+void Convolver::convolveDirect(const std::complex<float> *seq, int seqLen, std::complex<float> *output) const {
+    int filLen = Convolver::filter.size();
+    const std::complex<float> *fil = &Convolver::filter[0];
+
+    for (int n = 0; n < seqLen + filLen - 1; n++) {
+        // only the taps that overlap the sequence
+        int first = std::max(0, n - seqLen + 1);
+        int last = std::min(filLen - 1, n);
+
+        // multiply out the real and imaginary parts, as std::complex
+        // multiplication checks every product for infinities
+        float re = 0;
+        float im = 0;
+        for (int i = first; i <= last; i++) {
+            const std::complex<float> &a = fil[i];
+            const std::complex<float> &b = seq[n - i];
+            re += a.real() * b.real() - a.imag() * b.imag();
+            im += a.real() * b.imag() + a.imag() * b.real();
+        } // for
+        output[n] = std::complex<float>(re, im);
+    } // for
+}
+
+void Convolver::overlapAdd(const std::complex<float> *seq, int seqLen, std::complex<float> *output) const {
+    int filLen = Convolver::filter.size();
+    int n = Convolver::fftLen;
+    int step = n - filLen + 1;
+    int outLen = seqLen + filLen - 1;
+
+    std::vector<std::complex<float>> block(n);
+    std::fill(output, output + outLen, std::complex<float>(0, 0));
+
+    for (int start = 0; start < seqLen; start += step) {
+        int count = std::min(step, seqLen - start);
+
+        std::copy(seq + start, seq + start + count, block.begin());
+        std::fill(block.begin() + count, block.end(), std::complex<float>(0, 0));
+
+        Convolver::plan->execute(&block[0]);
+        Simd::complexMultiply(&block[0], &Convolver::spectrum[0], &block[0], n);
+        Convolver::plan->executeInverse(&block[0]);
+
+        // the tail of each block overlaps the start of the next
+        int end = std::min(start + count + filLen - 1, outLen);
+        for (int i = start; i < end; i++) {
+            output[i] += block[i - start];
+        } // for
+    } // for
+}
+
+void Convolver::overlapSave(const std::complex<float> *seq, int seqLen, std::complex<float> *output) const {
+    int filLen = Convolver::filter.size();
+    int n = Convolver::fftLen;
+    int step = n - filLen + 1;
+    int outLen = seqLen + filLen - 1;
+
+    std::vector<std::complex<float>> block(n);
+
+    // block b reads seq[start - filLen + 1, start + step) and
+    // the first filLen - 1 outputs have wrapped around
+    for (int start = 0; start < outLen; start += step) {
+        int from = start - filLen + 1;
+        int lo = std::min(n, std::max(0, -from));
+        int hi = std::max(lo, std::min(n, seqLen - from));
+
+        std::fill(block.begin(), block.begin() + lo, std::complex<float>(0, 0));
+        std::copy(seq + from + lo, seq + from + hi, block.begin() + lo);
+        std::fill(block.begin() + hi, block.end(), std::complex<float>(0, 0));
+
+        Convolver::plan->execute(&block[0]);
+        Simd::complexMultiply(&block[0], &Convolver::spectrum[0], &block[0], n);
+        Convolver::plan->executeInverse(&block[0]);
+
+        int count = std::min(step, outLen - start);
+        std::copy(block.begin() + filLen - 1, block.begin() + filLen - 1 + count, output + start);
+    } // for
+}
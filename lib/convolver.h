@@ -0,0 +1,92 @@
+#ifndef CONVOLVER_H
+#define CONVOLVER_H
+
+#include <complex>
+#include <memory>
+#include <vector>
+#include "fftplan.h"
+
+class Convolver {
+    public:
+        enum Method {
+            // direct for short filters, otherwise overlap-save
+            AUTO,
+            // O(N*M) sum over the filter taps
+            DIRECT,
+            // zero padded input blocks, whose transformed tails are added together
+            OVERLAP_ADD,
+            // overlapping input blocks, whose wrapped-around outputs are discarded
+            OVERLAP_SAVE
+        };
+
+        /**
+         * @brief Construct a new Convolver object for a fixed filter. The spectrum
+         * of the filter is computed once here and reused by every convolution.
+         *
+         * @param filter Filter coefficients
+         * @param method Convolution method
+         * @param fftLen Block FFT length of the FFT methods, a power of two of at least
+         * twice the filter length. By default the length with the fewest operations per output.
+         */
+        Convolver(const std::vector<std::complex<float>> &filter, Method method=AUTO, int fftLen=0);
+
+        ~Convolver();
+
+        /**
+         * @brief Gets the filter coefficients
+         *
+         * @return const std::vector<std::complex<float>>&
+         */
+        const std::vector<std::complex<float>> &getFilter() const;
+
+        /**
+         * @brief Gets the method used, which is never AUTO
+         *
+         * @return Method
+         */
+        Method getMethod() const;
+
+        /**
+         * @brief Gets the block FFT length, or 0 for the direct method
+         *
+         * @return int
+         */
+        int getFFTLen() const;
+
+        /**
+         * @brief Computes the full linear convolution of a sequence with the filter
+         *
+         * @param seq Sequence to convolve
+         * @param seqLen Sequence length
+         * @param output Output of seqLen + filter length - 1 values, which must not alias seq
+         */
+        void convolve(const std::complex<float> *seq, int seqLen, std::complex<float> *output) const;
+
+        /**
+         * @brief Computes the full linear convolution of a sequence with the filter
+         *
+         * @param seq Sequence to convolve
+         * @return std::vector<std::complex<float>> of seq.size() + filter length - 1 values
+         */
+        std::vector<std::complex<float>> convolve(const std::vector<std::complex<float>> &seq) const;
+
+        /**
+         * @brief Filters no longer than this are convolved directly by AUTO
+         */
+        static const int directMaxLen = 16;
+
+    private:
+        void convolveDirect(const std::complex<float> *seq, int seqLen, std::complex<float> *output) const;
+        void overlapAdd(const std::complex<float> *seq, int seqLen, std::complex<float> *output) const;
+        void overlapSave(const std::complex<float> *seq, int seqLen, std::complex<float> *output) const;
+
+        std::vector<std::complex<float>> filter;
+        Method method;
+        int fftLen;
+
+        std::shared_ptr<FFTPlan> plan;
+        // filter spectrum, scaled by 1/fftLen to normalise the inverse FFT
+        std::vector<std::complex<float>> spectrum;
+};
+
+#endif // CONVOLVER_H
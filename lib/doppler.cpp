@@ -5,40 +5,55 @@
 
 using namespace std;
 
-# define C 343
-
 Doppler::Doppler(int transFreq)
     : transmitFreq(transFreq) 
 { }
 
 Doppler::~Doppler() { }
 
-std::vector<float> Doppler::measureProjectileVelocity(std::vector<float> receivedFreq) {
-    std::vector<float> estimProjVel;
+std::vector<float> Doppler::measureProjectileVelocity(const std::vector<float> &receivedFreq) {
+    std::vector<float> estimProjVel(receivedFreq.size());
+    if (!receivedFreq.empty()) {
+        Doppler::measureProjectileVelocity(&receivedFreq[0], receivedFreq.size(), &estimProjVel[0]);
+    } // if
 
-    for (int i = 0; i < receivedFreq.size(); i++) {
-        float vel = C * (Doppler::transmitFreq - receivedFreq[i])/(Doppler::transmitFreq + receivedFreq[i]);
-        estimProjVel.push_back(vel);
-    }
-    
     return estimProjVel;
 }
 
-std::vector<float> Doppler::estimDistanceTravelled(std::vector<float> estimProjVel, std::vector<float> timeSteps) {
-    std::vector<float> estimProjDis;
-    float dis = 0;
-    estimProjDis.push_back(dis);
+std::vector<std::vector<float>> Doppler::measureProjectileVelocity(const std::vector<std::vector<Detection>> &detections) {
+    std::vector<std::vector<float>> estimProjVel(detections.size());
+
+    // each frame's frequencies are gathered into its row, which is
+    // then converted in place by the vectorised overload
+    for (int i = 0; i < detections.size(); i++) {
+        std::vector<float> &row = estimProjVel[i];
+        row.resize(detections[i].size());
+        for (int j = 0; j < row.size(); j++) {
+            row[j] = detections[i][j].freq;
+        } // for
+
+        if (!row.empty()) {
+            Doppler::measureProjectileVelocity(&row[0], row.size(), &row[0]);
+        } // if
+    } // for
+
+    return estimProjVel;
+}
+
+std::vector<float> Doppler::estimDistanceTravelled(const std::vector<float> &estimProjVel, const std::vector<float> &timeSteps) {
+    std::vector<float> estimProjDis(estimProjVel.size());
+    if (!estimProjVel.empty()) {
+        Doppler::estimDistanceTravelled(&estimProjVel[0], &timeSteps[0], estimProjVel.size(), &estimProjDis[0]);
+    } // if
 
-    for (int i = 1; i < estimProjVel.size(); i++) {
-        dis += (timeSteps[i]-timeSteps[i-1])*estimProjVel[i];
-        estimProjDis.push_back(dis);
-    }
-    
     return estimProjDis;
 }
 
-std::vector<float> Doppler::measureTransverseDistance(std::vector<float> estimProjVel, std::vector<float> timeSteps) {
-    std::vector<float> transDis;
+std::vector<float> Doppler::measureTransverseDistance(const std::vector<float> &estimProjVel, const std::vector<float> &timeSteps) {
+    std::vector<float> transDis(estimProjVel.size());
+    if (estimProjVel.empty()) {
+        return transDis;
+    } // if
 
     // here we break causality by estimating the steady
     // state object velocity by finding the mode
@@ -59,27 +74,45 @@ std::vector<float> Doppler::measureTransverseDistance(std::vector<float> estimPr
         } // if
     } // for
 
-    // hypotenuse distance
-    std::vector<float> hypDis = Doppler::estimDistanceTravelled(estimProjVel, timeSteps);
+    Doppler::measureTransverseDistance(&estimProjVel[0], &timeSteps[0], estimProjVel.size(), velSS, &transDis[0]);
 
-    // estimate cos(angle) between reciever and object
-    std::vector<float> alpha;
+    return transDis;
+}
 
-    for (int i = 0; i < estimProjVel.size(); i++) {
-        alpha.push_back(acos(estimProjVel[i] / velSS));
+void Doppler::measureProjectileVelocity(const float *receivedFreq, int count, float *estimProjVel) const {
+    float transmit = Doppler::transmitFreq;
+
+    // no branches or calls, so the loop vectorises
+    for (int i = 0; i < count; i++) {
+        estimProjVel[i] = Doppler::speedOfSound * (transmit - receivedFreq[i])/(transmit + receivedFreq[i]);
     } // for
+}
 
+void Doppler::estimDistanceTravelled(const float *estimProjVel, const float *timeSteps, int count, float *estimProjDis) const {
+    if (count <= 0) {
+        return;
+    } // if
 
-    for (int i = 0; i < hypDis.size(); i++) {
-        // prevent NANs
-        float cosAlpha = cos(alpha[i] - M_PI/2);
-        if (alpha[i] <= 0 || alpha[i] > M_PI || isnan(alpha[i])) {
-            transDis.push_back(0);
-        } else {
-            transDis.push_back(hypDis[i] * cosAlpha);
-        } // else
+    // the steps are independent, only their prefix sum is serial
+    estimProjDis[0] = 0;
+    for (int i = 1; i < count; i++) {
+        estimProjDis[i] = (timeSteps[i]-timeSteps[i-1])*estimProjVel[i];
+    } // for
+    for (int i = 1; i < count; i++) {
+        estimProjDis[i] += estimProjDis[i-1];
     } // for
-    
+}
 
-    return transDis;
-}
\ No newline at end of file
+void Doppler::measureTransverseDistance(const float *estimProjVel, const float *timeSteps, int count, float velSS, float *transDis) const {
+    // hypotenuse distance
+    Doppler::estimDistanceTravelled(estimProjVel, timeSteps, count, transDis);
+
+    // with x = cos(alpha), the velocity over the steady state velocity,
+    // cos(alpha - pi/2) = sin(alpha) = sqrt(1 - x^2) for alpha in (0, pi]
+    for (int i = 0; i < count; i++) {
+        float x = estimProjVel[i] / velSS;
+        bool valid = x >= -1 && x < 1;
+        float sinAlpha = sqrtf(valid ? 1 - x * x : 0);
+        transDis[i] = valid ? transDis[i] * sinAlpha : 0;
+    } // for
+}
@@ -2,7 +2,7 @@
 #define DOPPLER_H
 
 #include <vector>
-
+#include "cfar.h"
 
 class Doppler {
     public:
@@ -14,13 +14,27 @@ class Doppler {
         Doppler(int transFreq);
         ~Doppler();
 
+        /**
+         * @brief Speed of sound in air (m/s), shared by the Doppler estimates
+         */
+        static constexpr float speedOfSound = 343;
+
         /**
          * @brief Measures the velocity (m/s) of a projectile from a stationary source
          * 
          * @param receivedFreq Time series of recieved frequencies
          * @return std::vector<float> 
          */
-        std::vector<float> measureProjectileVelocity(std::vector<float> receivedFreq);
+        std::vector<float> measureProjectileVelocity(const std::vector<float> &receivedFreq);
+
+        /**
+         * @brief Measures the velocity (m/s) of every target detected in each
+         * frame, e.g. by Cfar::detect
+         * 
+         * @param detections Detections of each frame
+         * @return std::vector<std::vector<float>> with the velocities of each frame, in the order of the detections
+         */
+        std::vector<std::vector<float>> measureProjectileVelocity(const std::vector<std::vector<Detection>> &detections);
         
         /**
          * @brief Estimates distance travelled by discretely
@@ -30,7 +44,7 @@ class Doppler {
          * @param timeSteps Time series in seconds (s)
          * @return std::vector<float> 
          */
-        std::vector<float> estimDistanceTravelled(std::vector<float> estimProjVel, std::vector<float> timeSteps);
+        std::vector<float> estimDistanceTravelled(const std::vector<float> &estimProjVel, const std::vector<float> &timeSteps);
 
         /**
          * @brief Estimates transverse distance between moving object
@@ -40,7 +54,42 @@ class Doppler {
          * @param timeSteps Time series in seconds (s)
          * @return std::vector<float> 
          */
-        std::vector<float> measureTransverseDistance(std::vector<float> estimProjVel, std::vector<float> timeSteps);
+        std::vector<float> measureTransverseDistance(const std::vector<float> &estimProjVel, const std::vector<float> &timeSteps);
+
+        /**
+         * @brief Measures the velocity (m/s) of a projectile from a stationary
+         * source into a caller provided array
+         * 
+         * @param receivedFreq count recieved frequencies
+         * @param count Number of values
+         * @param estimProjVel count velocities, may be receivedFreq
+         */
+        void measureProjectileVelocity(const float *receivedFreq, int count, float *estimProjVel) const;
+
+        /**
+         * @brief Estimates distance travelled by discretely integrating
+         * a time series of object velocities into a caller provided array
+         * 
+         * @param estimProjVel count velocities
+         * @param timeSteps count times in seconds (s)
+         * @param count Number of values
+         * @param estimProjDis count distances
+         */
+        void estimDistanceTravelled(const float *estimProjVel, const float *timeSteps, int count, float *estimProjDis) const;
+
+        /**
+         * @brief Estimates transverse distance between moving object and a
+         * stationary observer, given its steady state velocity, e.g. from
+         * DopplerTracker, into a caller provided array. The distance is 0 where
+         * the velocity is not in [-velSS, velSS).
+         * 
+         * @param estimProjVel count velocities
+         * @param timeSteps count times in seconds (s)
+         * @param count Number of values
+         * @param velSS Steady state velocity
+         * @param transDis count distances
+         */
+        void measureTransverseDistance(const float *estimProjVel, const float *timeSteps, int count, float velSS, float *transDis) const;
     
     private:
         int transmitFreq;
@@ -0,0 +1,142 @@
+#include <cmath>
+#include <algorithm>
+#include <stdexcept>
+#include "dopplertracker.h"
+#include "doppler.h"
+
+using namespace std;
+
+DopplerTracker::DopplerTracker(int transFreq, float gate, int maxMisses, float velocityResolution) :
+transmitFreq(transFreq), gate(gate), maxMisses(maxMisses), velocityResolution(velocityResolution), nextId(0) {
+    if (gate <= 0 || maxMisses < 0 || velocityResolution <= 0) {
+        throw std::invalid_argument("DopplerTracker: the gate and velocity resolution must be positive");
+    } // if
+
+    // velocities lie in (-c, c] for any received frequency
+    DopplerTracker::histogramBins = (int) std::ceil(2 * Doppler::speedOfSound / velocityResolution) + 1;
+}
+
+DopplerTracker::~DopplerTracker() { }
+
+const std::vector<Track> &DopplerTracker::update(const std::vector<Detection> &detections, float time) {
+    DopplerTracker::detectionFreqs.clear();
+    for (int i = 0; i < detections.size(); i++) {
+        DopplerTracker::detectionFreqs.push_back(detections[i].freq);
+    } // for
+
+    return DopplerTracker::update(DopplerTracker::detectionFreqs, time);
+}
+
+const std::vector<Track> &DopplerTracker::update(const std::vector<float> &freqs, float time) {
+    int numTracks = DopplerTracker::tracks.size();
+
+    // pair the closest track and detection first, until the gate is reached
+    DopplerTracker::pairs.clear();
+    for (int t = 0; t < numTracks; t++) {
+        for (int d = 0; d < freqs.size(); d++) {
+            float dist = std::fabs(freqs[d] - DopplerTracker::tracks[t].freq);
+            if (dist <= DopplerTracker::gate) {
+                DopplerTracker::pairs.push_back(std::make_pair(dist, std::make_pair(t, d)));
+            } // if
+        } // for
+    } // for
+    std::sort(DopplerTracker::pairs.begin(), DopplerTracker::pairs.end());
+
+    DopplerTracker::trackUsed.assign(numTracks, false);
+    DopplerTracker::freqUsed.assign(freqs.size(), false);
+    for (int i = 0; i < DopplerTracker::pairs.size(); i++) {
+        int t = DopplerTracker::pairs[i].second.first;
+        int d = DopplerTracker::pairs[i].second.second;
+        if (!DopplerTracker::trackUsed[t] && !DopplerTracker::freqUsed[d]) {
+            DopplerTracker::trackUsed[t] = true;
+            DopplerTracker::freqUsed[d] = true;
+            DopplerTracker::advance(t, freqs[d], time);
+        } // if
+    } // for
+
+    // drop the tracks that have missed too many frames, keeping the order
+    int kept = 0;
+    for (int t = 0; t < numTracks; t++) {
+        if (!DopplerTracker::trackUsed[t]) {
+            DopplerTracker::tracks[t].misses++;
+        } // if
+
+        if (DopplerTracker::tracks[t].misses <= DopplerTracker::maxMisses) {
+            if (kept != t) {
+                DopplerTracker::tracks[kept] = DopplerTracker::tracks[t];
+                std::swap(DopplerTracker::histograms[kept], DopplerTracker::histograms[t]);
+            } // if
+            kept++;
+        } // if
+    } // for
+    DopplerTracker::tracks.resize(kept);
+    DopplerTracker::histograms.resize(kept);
+
+    for (int d = 0; d < freqs.size(); d++) {
+        if (!DopplerTracker::freqUsed[d]) {
+            DopplerTracker::start(freqs[d], time);
+        } // if
+    } // for
+
+    return DopplerTracker::tracks;
+}
+
+const std::vector<Track> &DopplerTracker::getTracks() const {
+    return DopplerTracker::tracks;
+}
+
+void DopplerTracker::reset() {
+    DopplerTracker::tracks.clear();
+    DopplerTracker::histograms.clear();
+    DopplerTracker::nextId = 0;
+}
+
+void DopplerTracker::start(float freq, float time) {
+    Track track = {DopplerTracker::nextId++, time, freq, 0, 0, 0, 0, 0, 0};
+    DopplerTracker::tracks.push_back(track);
+
+    Histogram histogram;
+    histogram.mode = -1;
+    DopplerTracker::histograms.push_back(histogram);
+
+    DopplerTracker::advance(DopplerTracker::tracks.size() - 1, freq, time);
+}
+
+void DopplerTracker::advance(int t, float freq, float time) {
+    Track &track = DopplerTracker::tracks[t];
+    Histogram &histogram = DopplerTracker::histograms[t];
+
+    track.velocity = DopplerTracker::velocity(freq);
+    if (track.hits > 0) {
+        track.distance += (time - track.time) * track.velocity;
+    } // if
+    track.time = time;
+    track.freq = freq;
+    track.hits++;
+    track.misses = 0;
+
+    // a velocity only raises its own bin, so the mode can only move to it
+    int bin = (int) std::floor((track.velocity + Doppler::speedOfSound) / DopplerTracker::velocityResolution);
+    bin = std::max(0, std::min(DopplerTracker::histogramBins - 1, bin));
+    HistogramBin &entry = histogram.bins[bin];
+    entry.count++;
+    entry.sum += track.velocity;
+    if (histogram.mode < 0 || entry.count > histogram.modeCount) {
+        histogram.mode = bin;
+        histogram.modeCount = entry.count;
+    } // if
+    const HistogramBin &mode = histogram.bins[histogram.mode];
+    track.steadyVelocity = mode.sum / mode.count;
+
+    // cos(acos(x) - pi/2) = sqrt(1 - x^2), taken as 0 outside [-1, 1)
+    float x = track.velocity / track.steadyVelocity;
+    if (x >= -1 && x < 1) {
+        track.transverse = track.distance * std::sqrt(1 - x * x);
+    } else {
+        track.transverse = 0;
+    } // else
+}
+
+float DopplerTracker::velocity(float freq) const {
+    return Doppler::speedOfSound * (DopplerTracker::transmitFreq - freq)/(DopplerTracker::transmitFreq + freq);
+}
@@ -0,0 +1,121 @@
+#ifndef DOPPLERTRACKER_H
+#define DOPPLERTRACKER_H
+
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "cfar.h"
+
+/**
+ * @brief The estimates of one tracked target
+ */
+struct Track {
+    int id;
+    // time of the last update (s)
+    float time;
+    // received frequency of the last associated detection (Hz)
+    float freq;
+    // velocity (m/s), from the last associated frequency
+    float velocity;
+    // distance travelled since the track started (m)
+    float distance;
+    // steady state velocity (m/s), the mode of the velocities so far
+    float steadyVelocity;
+    // transverse distance between the target and the observer (m)
+    float transverse;
+    // number of frames with a detection
+    int hits;
+    // number of consecutive frames without a detection
+    int misses;
+};
+
+class DopplerTracker {
+    public:
+        /**
+         * @brief Construct a new DopplerTracker object, which follows targets from
+         * frame to frame as the detections arrive. Each detection is associated
+         * with the track whose last frequency is nearest, within a gate, and
+         * the track's velocity, distance and transverse estimates are advanced
+         * from their previous values, so a frame costs the same however long
+         * the capture. The steady state velocity is the mode of a histogram
+         * of the track's velocities, kept up to date as each one is added,
+         * so noisy velocities still have a mode.
+         *
+         * @param transFreq Known transmission frequency of Doppler radar
+         * @param gate Largest change of frequency (Hz) between frames of one track
+         * @param maxMisses Number of consecutive frames without a detection before a track is dropped
+         * @param velocityResolution Width of the velocity histogram bins (m/s)
+         */
+        DopplerTracker(int transFreq, float gate, int maxMisses=3, float velocityResolution=1);
+
+        ~DopplerTracker();
+
+        /**
+         * @brief Advances the tracks to a new frame. Detections not associated
+         * with a track start new ones.
+         *
+         * @param freqs Received frequencies of the frame's detections (Hz)
+         * @param time Time of the frame (s)
+         * @return const std::vector<Track>& the live tracks, oldest first
+         */
+        const std::vector<Track> &update(const std::vector<float> &freqs, float time);
+
+        /**
+         * @brief Advances the tracks to a new frame of detections, e.g. from Cfar::detect
+         *
+         * @param detections Detections of the frame
+         * @param time Time of the frame (s)
+         * @return const std::vector<Track>& the live tracks, oldest first
+         */
+        const std::vector<Track> &update(const std::vector<Detection> &detections, float time);
+
+        /**
+         * @brief Get the live tracks
+         *
+         * @return const std::vector<Track>&
+         */
+        const std::vector<Track> &getTracks() const;
+
+        /**
+         * @brief Drops every track
+         */
+        void reset();
+
+    private:
+        struct HistogramBin {
+            int count;
+            float sum;
+        };
+
+        // velocity histogram of a track, holding only the bins it has
+        // velocities in, as a track covers few of the 2c/resolution bins
+        struct Histogram {
+            std::unordered_map<int, HistogramBin> bins;
+            int mode;
+            int modeCount;
+        };
+
+        void start(float freq, float time);
+        void advance(int track, float freq, float time);
+
+        float velocity(float freq) const;
+
+        int transmitFreq;
+        float gate;
+        int maxMisses;
+        float velocityResolution;
+        // bins of velocities in (-c, c], which the histograms are keyed by
+        int histogramBins;
+        int nextId;
+
+        std::vector<Track> tracks;
+        std::vector<Histogram> histograms;
+
+        // scratch space of update
+        std::vector<float> detectionFreqs;
+        std::vector<std::pair<float, std::pair<int, int>>> pairs;
+        std::vector<bool> trackUsed;
+        std::vector<bool> freqUsed;
+};
+
+#endif // DOPPLERTRACKER_H
@@ -1,7 +1,9 @@
 #include <iostream>
 #include <complex>
 #include <cmath>
-#include <map>
+#include <vector>
+#include <memory>
+#include <utility>
 #include "fft.h"
 
 using namespace std;
@@ -18,62 +20,65 @@ int FFT::getFFTLen() {
 }
 
 std::complex<float> *FFT::getResult() {
-    return FFT::radix_2_fft;
+    return &FFT::radix_2_fft[0];
 }
 
 void FFT::computeDit(float *points,int len) {
-    // base case is len == 2
-    if (len == 2) {
-        return;
-    } else {
-        // place even index in first half
-        // and odd indexes in second
-        float * even_temp = (float*) malloc(len/2 * sizeof(float*));
-        float * odd_temp = (float*) malloc(len/2 * sizeof(float*));
-
-        for (int i = 0; i < len/2; i++) {
-            float temp = *(points+i*2);
-            *(even_temp+i) = temp;
-
-            temp = *(points+1+i*2);
-            *(odd_temp+i) = temp;
-        } // for
-
-        for (int i = 0; i < len/2; i++) {
-            float temp = *(even_temp+i);
-            *(points+i) = temp;
-
-            temp = *(odd_temp+i);
-            *(points+len/2+i) = temp;
-        } // for
-        
-        // call two len / 2 decimation functions
-        FFT::computeDit(points,len/2);
-        FFT::computeDit(points+len/2,len/2);
-
-    } // else
+    // the repeated even/odd decimation is equivalent to reversing
+    // the bits of each index, so swap each pair once in place
+    for (int i = 0, j = 0; i < len; i++) {
+        if (i < j) {
+            std::swap(points[i], points[j]);
+        } // if
+
+        // increment j as a bit-reversed counter
+        int bit = len >> 1;
+        while (j & bit) {
+            j ^= bit;
+            bit >>= 1;
+        } // while
+        j |= bit;
+    } // for
 }
 
 void FFT::computeDit(std::vector<std::complex<float>> *signal, int len) {
-    for (int i = len; i > 2; i/=2) {
-        std::vector<std::complex<float>> temp (len,0);
-        for (int j = 0; j < len; j+=i) {
-            // place even index in first half
-            // and odd indexes in second
-            for (int k = 0; k < i/2; k++) {
-                temp[k + j] = (*signal)[k*2 + j];
-                temp[k + j + i/2] = (*signal)[k*2 + j + 1];
-            } // for
-        } // for
-
-        (*signal).swap(temp);
+    std::complex<float> *points = &(*signal)[0];
+
+    for (int i = 0, j = 0; i < len; i++) {
+        if (i < j) {
+            std::swap(points[i], points[j]);
+        } // if
+
+        int bit = len >> 1;
+        while (j & bit) {
+            j ^= bit;
+            bit >>= 1;
+        } // while
+        j |= bit;
     } // for
 }
 
+const FFTPlan &FFT::getPlan(int len) {
+    // plans are only rebuilt when the transform length changes
+    if (!FFT::plan || FFT::plan->getFFTLen() != len) {
+        FFT::plan = std::make_shared<FFTPlan>(len);
+    } // if
+
+    return *FFT::plan;
+}
+
+const RealFFTPlan &FFT::getRealPlan(int len) {
+    if (!FFT::realPlan || FFT::realPlan->getFFTLen() != len) {
+        FFT::realPlan = std::make_shared<RealFFTPlan>(len);
+    } // if
+
+    return *FFT::realPlan;
+}
+
 void FFT::computeTwiddles() {
     // we want to instantiate all the possibilities for W_N^k
-    // std::map<std::pair<int,int>,std::complex<float>> twiddles;
-    FFT::twiddles.clear();
+    // in a flat table, so a lookup is a single indexed load
+    FFT::twiddles.resize(FFT::len/2);
 
     for (int k = 0; k < FFT::len/2; k++) {
         complex<float> twid = std::polar(((float) 1), ((float)(-(2*M_PI*k)/len)));
@@ -87,13 +92,13 @@ std::complex<float> FFT::getTwiddle(int k) {
 }
 
 void FFT::toComplex(float *points,int len) {
-    // allocate memory for fft result
-    FFT::radix_2_fft = (std::complex<float>*) malloc(len * sizeof(std::complex<float>*));
+    // the result buffer is reused between calls, and only
+    // grows when a longer sequence is transformed
+    FFT::radix_2_fft.resize(len);
 
     // cast float -> complex
     for (int i = 0; i < len; i++) {
-        complex<float> tmp (*(points+i),(float)0);
-        *(FFT::radix_2_fft + i) = tmp;
+        FFT::radix_2_fft[i] = complex<float>(*(points+i),(float)0);
     } // for
 }
 
@@ -151,22 +156,22 @@ void FFT::nPointButterfly(std::vector<std::complex<float>> *signal, int k, int n
 std::complex<float> *FFT::computeDitFft(float *points,int len) {
     FFT::len = len;
 
-    // precompute the twiddles for the DFT
-    FFT::computeTwiddles();
+    if (len % 2 != 0) {
+        // odd lengths have no real-input plan
+        FFT::toComplex(points,len);
+        FFT::getPlan(len).execute(&FFT::radix_2_fft[0]);
+        return &FFT::radix_2_fft[0];
+    } // if
 
-    // decimate the signal in time
-    FFT::computeDit(points,len);
+    // the input is real, so only bins 0..len/2 need computing
+    FFT::radix_2_fft.resize(len);
+    FFT::getRealPlan(len).execute(points, &FFT::radix_2_fft[0]);
 
-    // create complex input
-    FFT::toComplex(points,len);
-
-    // reconstruct the signal in z-domain
-    for (int n = 2; n <= len; n*=2) {
-        for (int k = 0; k < len/n; k++) {
-            FFT::nPointButterfly((FFT::radix_2_fft+k*n),n);
-        } // for
+    // the upper half is the conjugate of the lower half
+    for (int k = 1; k < len/2; k++) {
+        FFT::radix_2_fft[len - k] = std::conj(FFT::radix_2_fft[k]);
     } // for
     clog << "fft complete" << endl;
 
-    return FFT::radix_2_fft;
-}
\ No newline at end of file
+    return &FFT::radix_2_fft[0];
+}
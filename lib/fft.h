@@ -3,7 +3,8 @@
 
 #include <complex>
 #include <vector>
-#include <map>
+#include <memory>
+#include "fftplan.h"
 
 class FFT {
     public:
@@ -11,7 +12,8 @@ class FFT {
         ~FFT();
 
         /**
-         * @brief Inplace recursive function to decimate a sequence for radix-2 FFT
+         * @brief Inplace function to decimate a sequence for radix-2 FFT, by
+         * swapping each value with its bit-reversed index. Allocates nothing.
          * 
          * @param points Pointer to sequence to decimate
          * @param len The length of the array
@@ -20,7 +22,8 @@ class FFT {
         void computeDit(float *points, int len);
 
         /**
-         * @brief Inplace recursive function to decimate a sequence for radix-2 FFT.
+         * @brief Inplace function to decimate a sequence for radix-2 FFT, by
+         * swapping each value with its bit-reversed index. Allocates nothing.
          * 
          * @param signal Signal to decimate
          * @param len Length of decimation
@@ -55,7 +58,7 @@ class FFT {
         void computeTwiddles();
 
         /**
-         * @brief Get a value from the twiddle map
+         * @brief Get a value from the twiddle table
          * 
          * @param k 
          * 
@@ -99,7 +102,27 @@ class FFT {
         void nPointButterfly(std::vector<std::complex<float>> *signal, int k, int n);
 
         /**
-         * @brief Computes the Cooley–Tukey FFT algorithm FFT of a real DIT sequence
+         * @brief Get the FFT plan for a given length. The plan is cached and
+         * only rebuilt when the requested length changes.
+         * 
+         * @param len Length of the FFT
+         * @return const FFTPlan& 
+         */
+        const FFTPlan &getPlan(int len);
+
+        /**
+         * @brief Get the real-input FFT plan for a given length. The plan is cached
+         * and only rebuilt when the requested length changes.
+         * 
+         * @param len Length of the FFT. Must be even, and at least 2.
+         * @return const RealFFTPlan& 
+         */
+        const RealFFTPlan &getRealPlan(int len);
+
+        /**
+         * @brief Computes the Cooley–Tukey FFT algorithm FFT of a real sequence.
+         * The non-redundant half of the spectrum is computed with a real-input FFT,
+         * and the other half filled in by conjugate symmetry. The input is left unchanged.
          * 
          * @param points Signal from which the FFT is computed
          * @return float* 
@@ -108,8 +131,10 @@ class FFT {
     
     private:
         int len;
-        std::complex<float> *radix_2_fft;
-        std::map<int,std::complex<float>> twiddles;
+        std::vector<std::complex<float>> radix_2_fft;
+        std::shared_ptr<FFTPlan> plan;
+        std::shared_ptr<RealFFTPlan> realPlan;
+        std::vector<std::complex<float>> twiddles;
 };
 
 #endif // FFT_H
\ No newline at end of file
@@ -0,0 +1,532 @@
+#include <complex>
+#include <cstring>
+#include <cmath>
+#include <stdexcept>
+#include <algorithm>
+#include <memory>
+#include <utility>
+#include "fftplan.h"
+#include "simd.h"
+
+using namespace std;
+
+namespace {
+
+inline std::complex<float> mul(std::complex<float> a, std::complex<float> w) {
+    return std::complex<float>(a.real() * w.real() - a.imag() * w.imag(),
+                               a.real() * w.imag() + a.imag() * w.real());
+}
+
+inline std::complex<float> twiddle(double angle) {
+    return std::complex<float>((float) cos(angle), (float) sin(angle));
+}
+
+} // namespace
+
+FFTPlan::FFTPlan(int len, Engine engine) : len(len), engine(engine) {
+    if (len < 1) {
+        throw std::invalid_argument("FFTPlan: length must be positive");
+    } // if
+
+    bool powerOfTwo = (len & (len - 1)) == 0;
+
+    // factor the length into the radices with a butterfly,
+    // as (radix, remaining length) pairs
+    int rest = len;
+    while (rest % 4 == 0 && rest > 4) {
+        FFTPlan::factors.push_back(4);
+        rest /= 4;
+        FFTPlan::factors.push_back(rest);
+    } // while
+    const int radices[] = {4, 2, 3, 5, 7};
+    for (int r = 0; r < 5; r++) {
+        while (rest > 1 && rest % radices[r] == 0) {
+            FFTPlan::factors.push_back(radices[r]);
+            rest /= radices[r];
+            FFTPlan::factors.push_back(rest);
+        } // while
+    } // for
+    bool smooth = rest == 1;
+
+    if (engine == AUTO) {
+        if (powerOfTwo) {
+            // radix-4 does the fewest passes over memory for
+            // all sizes, and all stages run on the vectorized kernels
+            FFTPlan::engine = RADIX_4;
+        } else if (smooth) {
+            FFTPlan::engine = MIXED_RADIX;
+        } else {
+            FFTPlan::engine = BLUESTEIN;
+        } // else
+    } else if ((engine == RADIX_2 || engine == RADIX_4 || engine == SPLIT_RADIX) && !powerOfTwo) {
+        throw std::invalid_argument("FFTPlan: radix-2, radix-4 and split-radix lengths must be a power of two");
+    } else if (engine == MIXED_RADIX && !smooth) {
+        throw std::invalid_argument("FFTPlan: mixed-radix lengths must only have factors of 2, 3, 5 and 7");
+    } // else if
+
+    if (FFTPlan::engine == MIXED_RADIX) {
+        FFTPlan::initMixedRadix();
+    } else if (FFTPlan::engine == BLUESTEIN) {
+        FFTPlan::initBluestein();
+    } else {
+        FFTPlan::initPowerOfTwo();
+    } // else
+}
+
+void FFTPlan::initPowerOfTwo() {
+    int len = FFTPlan::len;
+
+    // per stage twiddles W_n^i, stored contiguously so each butterfly
+    // stage walks its table linearly
+    FFTPlan::twiddles.resize(len > 1 ? len - 1 : 1);
+
+    for (int n = 2; n <= len; n*=2) {
+        for (int i = 0; i < n/2; i++) {
+            FFTPlan::twiddles[n/2 - 1 + i] = twiddle(-(2*M_PI*i)/n);
+        } // for
+    } // for
+
+    // radix-4 and split-radix stages also twiddle a quarter by W_n^3k,
+    // W_n^k and W_n^2k are the first quarters of the n and n/2 tables
+    FFTPlan::twiddles3.resize(len >= 4 ? len/4 * 2 : 1);
+
+    for (int n = 4; n <= len; n*=2) {
+        for (int k = 0; k < n/4; k++) {
+            FFTPlan::twiddles3[n/4 - 1 + k] = twiddle(-(2*M_PI*3*k)/n);
+        } // for
+    } // for
+
+    // the repeated even/odd decimation of a radix-2 DIT FFT
+    // is equivalent to reversing the bits of each index
+    FFTPlan::bitReverse.resize(len);
+
+    int bits = 0;
+    while ((1 << bits) < len) {
+        bits++;
+    } // while
+
+    for (int i = 0; i < len; i++) {
+        int rev = 0;
+        for (int b = 0; b < bits; b++) {
+            rev |= ((i >> b) & 1) << (bits - 1 - b);
+        } // for
+        FFTPlan::bitReverse[i] = rev;
+    } // for
+}
+
+void FFTPlan::initMixedRadix() {
+    // every stage indexes W_len^k with a stride
+    FFTPlan::twiddles.resize(FFTPlan::len);
+
+    for (int k = 0; k < FFTPlan::len; k++) {
+        FFTPlan::twiddles[k] = twiddle(-(2*M_PI*k)/FFTPlan::len);
+    } // for
+
+    FFTPlan::scratch.resize(FFTPlan::len);
+}
+
+void FFTPlan::initBluestein() {
+    int len = FFTPlan::len;
+
+    // the chirp-z convolution of length 2*len - 1 is
+    // computed with a power of two FFT
+    int convLen = 1;
+    while (convLen < 2*len - 1) {
+        convLen *= 2;
+    } // while
+    FFTPlan::convPlan = std::make_shared<FFTPlan>(convLen);
+
+    // chirp[n] = exp(-j pi n^2 / len), with n^2 reduced mod 2*len for precision
+    FFTPlan::chirp.resize(len);
+    for (int n = 0; n < len; n++) {
+        long long sq = ((long long) n * n) % (2LL * len);
+        FFTPlan::chirp[n] = twiddle(-M_PI * sq / len);
+    } // for
+
+    // the spectrum of the conjugate chirp filter, scaled by 1/convLen
+    // to fold in the normalisation of the inverse FFT
+    FFTPlan::chirpSpectrum.assign(convLen, std::complex<float>(0, 0));
+    FFTPlan::chirpSpectrum[0] = std::conj(FFTPlan::chirp[0]);
+    for (int n = 1; n < len; n++) {
+        FFTPlan::chirpSpectrum[n] = std::conj(FFTPlan::chirp[n]);
+        FFTPlan::chirpSpectrum[convLen - n] = std::conj(FFTPlan::chirp[n]);
+    } // for
+
+    FFTPlan::convPlan->execute(&FFTPlan::chirpSpectrum[0]);
+
+    for (int k = 0; k < convLen; k++) {
+        FFTPlan::chirpSpectrum[k] /= (float) convLen;
+    } // for
+
+    FFTPlan::scratch.resize(convLen);
+}
+
+FFTPlan::~FFTPlan() {}
+
+int FFTPlan::getFFTLen() const {
+    return FFTPlan::len;
+}
+
+const std::complex<float> *FFTPlan::getTwiddles(int n) const {
+    return &FFTPlan::twiddles[n/2 - 1];
+}
+
+const int *FFTPlan::getBitReverse() const {
+    return &FFTPlan::bitReverse[0];
+}
+
+FFTPlan::Engine FFTPlan::getEngine() const {
+    return FFTPlan::engine;
+}
+
+const std::complex<float> *FFTPlan::getTwiddles3(int n) const {
+    return &FFTPlan::twiddles3[n/4 - 1];
+}
+
+void FFTPlan::execute(std::complex<float> *points) const {
+    // a single point is its own transform, and has no stages to run
+    if (FFTPlan::len == 1) {
+        return;
+    } // if
+
+    if (FFTPlan::engine == MIXED_RADIX) {
+        // the mixed-radix stages work out of place from a copy
+        std::copy(points, points + FFTPlan::len, FFTPlan::scratch.begin());
+        FFTPlan::mixedRadix(points, &FFTPlan::scratch[0], 1, &FFTPlan::factors[0]);
+        return;
+    } else if (FFTPlan::engine == BLUESTEIN) {
+        FFTPlan::executeBluestein(points);
+        return;
+    } // else if
+
+    // decimate the signal in time
+    FFTPlan::bitReversePermute(points);
+
+    // reconstruct the signal in z-domain
+    if (FFTPlan::engine == SPLIT_RADIX) {
+        FFTPlan::splitRadix(points, FFTPlan::len);
+    } else if (FFTPlan::engine == RADIX_4) {
+        FFTPlan::executeRadix4(points, 1, FFTPlan::len);
+    } else {
+        FFTPlan::executeRadix2(points, 1, FFTPlan::len);
+    } // else
+}
+
+void FFTPlan::executeBatch(std::complex<float> *points, int count, int stride) const {
+    if (FFTPlan::len == 1) {
+        return;
+    } // if
+
+    if (FFTPlan::engine == MIXED_RADIX || FFTPlan::engine == BLUESTEIN || FFTPlan::engine == SPLIT_RADIX) {
+        for (int f = 0; f < count; f++) {
+            FFTPlan::execute(points + f*stride);
+        } // for
+        return;
+    } // if
+
+    for (int f = 0; f < count; f++) {
+        FFTPlan::bitReversePermute(points + f*stride);
+    } // for
+
+    // run each stage over every frame before moving to the next,
+    // so each stages twiddles are loaded once and stay in cache
+    if (FFTPlan::engine == RADIX_4) {
+        FFTPlan::executeRadix4(points, count, stride);
+    } else {
+        FFTPlan::executeRadix2(points, count, stride);
+    } // else
+}
+
+void FFTPlan::executeInverse(std::complex<float> *points) const {
+    // ifft(x) = conj(fft(conj(x))), without the 1/len scaling
+    for (int i = 0; i < FFTPlan::len; i++) {
+        points[i] = std::conj(points[i]);
+    } // for
+
+    FFTPlan::execute(points);
+
+    for (int i = 0; i < FFTPlan::len; i++) {
+        points[i] = std::conj(points[i]);
+    } // for
+}
+
+void FFTPlan::bitReversePermute(std::complex<float> *points) const {
+    for (int i = 0; i < FFTPlan::len; i++) {
+        int j = FFTPlan::bitReverse[i];
+        if (i < j) {
+            std::swap(points[i], points[j]);
+        } // if
+    } // for
+}
+
+void FFTPlan::fourPointStage(std::complex<float> *points, int count) const {
+    // the 2 and 4 point stages have trivial twiddles (1 and -j),
+    // so compute them together as a single pass
+    for (int k = 0; k < count; k+=4) {
+        std::complex<float> a = points[k] + points[k + 1];
+        std::complex<float> b = points[k] - points[k + 1];
+        std::complex<float> c = points[k + 2] + points[k + 3];
+        std::complex<float> d = points[k + 2] - points[k + 3];
+        // -j * d
+        std::complex<float> jd(d.imag(), -d.real());
+
+        points[k] = a + c;
+        points[k + 2] = a - c;
+        points[k + 1] = b + jd;
+        points[k + 3] = b - jd;
+    } // for
+}
+
+void FFTPlan::executeRadix2(std::complex<float> *points, int count, int stride) const {
+    // frames packed back to back are swept as one sequence, as no
+    // butterfly block crosses a frame and every frame has the same twiddles
+    int span = stride == FFTPlan::len ? count * FFTPlan::len : FFTPlan::len;
+    int frames = stride == FFTPlan::len ? 1 : count;
+
+    int n = 2;
+    if (FFTPlan::len >= 4) {
+        for (int f = 0; f < frames; f++) {
+            FFTPlan::fourPointStage(points + f*stride, span);
+        } // for
+        n = 8;
+    } // if
+
+    for (; n <= FFTPlan::len; n*=2) {
+        const std::complex<float> *twid = FFTPlan::getTwiddles(n);
+
+        for (int f = 0; f < frames; f++) {
+            std::complex<float> *frame = points + f*stride;
+            for (int k = 0; k < span; k+=n) {
+                Simd::butterfly(frame + k, frame + k + n/2, twid, n/2);
+            } // for
+        } // for
+    } // for
+}
+
+void FFTPlan::executeRadix4(std::complex<float> *points, int count, int stride) const {
+    int span = stride == FFTPlan::len ? count * FFTPlan::len : FFTPlan::len;
+    int frames = stride == FFTPlan::len ? 1 : count;
+
+    // size of the sub-DFTs combined so far
+    int m = 1;
+    if (FFTPlan::len >= 4) {
+        for (int f = 0; f < frames; f++) {
+            FFTPlan::fourPointStage(points + f*stride, span);
+        } // for
+        m = 4;
+    } // if
+
+    for (; m*4 <= FFTPlan::len; m*=4) {
+        int n = m*4;
+        const std::complex<float> *w1 = FFTPlan::getTwiddles(n);
+        const std::complex<float> *w2 = FFTPlan::getTwiddles(n/2);
+        const std::complex<float> *w3 = FFTPlan::getTwiddles3(n);
+
+        for (int f = 0; f < frames; f++) {
+            std::complex<float> *frame = points + f*stride;
+            for (int k = 0; k < span; k+=n) {
+                Simd::radix4Butterfly(frame + k, frame + k + m, frame + k + 2*m, frame + k + 3*m, w1, w2, w3, m);
+            } // for
+        } // for
+    } // for
+
+    // when log2(len) is odd the last stage is radix-2
+    if (m*2 == FFTPlan::len) {
+        const std::complex<float> *twid = FFTPlan::getTwiddles(FFTPlan::len);
+
+        for (int f = 0; f < count; f++) {
+            std::complex<float> *frame = points + f*stride;
+            Simd::butterfly(frame, frame + m, twid, m);
+        } // for
+    } // if
+}
+
+void FFTPlan::splitRadix(std::complex<float> *points, int n) const {
+    if (n == 4) {
+        FFTPlan::fourPointStage(points, 4);
+        return;
+    } else if (n == 2) {
+        std::complex<float> a = points[0];
+        points[0] = a + points[1];
+        points[1] = a - points[1];
+        return;
+    } else if (n < 2) {
+        return;
+    } // else if
+
+    // in bit-reversed order the first half holds the even samples, and the
+    // last two quarters the x[4m+1] and x[4m+3] samples, each in bit-reversed order
+    FFTPlan::splitRadix(points, n/2);
+    FFTPlan::splitRadix(points + n/2, n/4);
+    FFTPlan::splitRadix(points + 3*n/4, n/4);
+
+    Simd::splitRadixButterfly(points, points + n/4, points + n/2, points + 3*n/4,
+        FFTPlan::getTwiddles(n), FFTPlan::getTwiddles3(n), n/4);
+}
+
+void FFTPlan::mixedRadix(std::complex<float> *out, const std::complex<float> *in, int stride, const int *factor) const {
+    int p = factor[0];
+    int m = factor[1];
+
+    // decimate in time: the p subsequences in[j + p*i] are transformed
+    // into consecutive blocks of m outputs
+    if (m == 1) {
+        for (int j = 0; j < p; j++) {
+            out[j] = in[j * stride];
+        } // for
+    } else {
+        for (int j = 0; j < p; j++) {
+            FFTPlan::mixedRadix(out + j*m, in + j*stride, stride*p, factor + 2);
+        } // for
+    } // else
+
+    const std::complex<float> *tw = &FFTPlan::twiddles[0];
+
+    if (p == 2) {
+        for (int k = 0; k < m; k++) {
+            std::complex<float> t = mul(out[k + m], tw[k * stride]);
+            out[k + m] = out[k] - t;
+            out[k] += t;
+        } // for
+    } else if (p == 4) {
+        for (int k = 0; k < m; k++) {
+            std::complex<float> s0 = mul(out[k + m], tw[k * stride]);
+            std::complex<float> s1 = mul(out[k + 2*m], tw[2 * k * stride]);
+            std::complex<float> s2 = mul(out[k + 3*m], tw[3 * k * stride]);
+
+            std::complex<float> s5 = out[k] - s1;
+            std::complex<float> a = out[k] + s1;
+            std::complex<float> s3 = s0 + s2;
+            std::complex<float> s4 = s0 - s2;
+
+            out[k] = a + s3;
+            out[k + 2*m] = a - s3;
+            // s5 -/+ j * s4
+            out[k + m] = std::complex<float>(s5.real() + s4.imag(), s5.imag() - s4.real());
+            out[k + 3*m] = std::complex<float>(s5.real() - s4.imag(), s5.imag() + s4.real());
+        } // for
+    } else {
+        // generic radix-p DFT, used for 3, 5 and 7
+        std::complex<float> in_p[7];
+
+        for (int k = 0; k < m; k++) {
+            for (int q = 0; q < p; q++) {
+                in_p[q] = out[k + q*m];
+            } // for
+
+            for (int q = 0; q < p; q++) {
+                // output k + q*m takes W_len^(stride * j * (k + q*m)) from input j
+                int idx = k + q*m;
+                int step = (stride * idx) % FFTPlan::len;
+                int twidx = 0;
+                std::complex<float> sum = in_p[0];
+
+                for (int j = 1; j < p; j++) {
+                    twidx += step;
+                    if (twidx >= FFTPlan::len) {
+                        twidx -= FFTPlan::len;
+                    } // if
+                    sum += mul(in_p[j], tw[twidx]);
+                } // for
+                out[idx] = sum;
+            } // for
+        } // for
+    } // else
+}
+
+void FFTPlan::executeBluestein(std::complex<float> *points) const {
+    int convLen = FFTPlan::convPlan->getFFTLen();
+    std::complex<float> *a = &FFTPlan::scratch[0];
+
+    // X[k] = chirp[k] * sum_n (x[n] chirp[n]) conj(chirp[k-n]),
+    // a convolution with the conjugate chirp
+    Simd::complexMultiply(points, &FFTPlan::chirp[0], a, FFTPlan::len);
+    std::fill(a + FFTPlan::len, a + convLen, std::complex<float>(0, 0));
+
+    FFTPlan::convPlan->execute(a);
+    Simd::complexMultiply(a, &FFTPlan::chirpSpectrum[0], a, convLen);
+
+    // inverse FFT by conjugating around a forward FFT
+    for (int i = 0; i < convLen; i++) {
+        a[i] = std::conj(a[i]);
+    } // for
+    FFTPlan::convPlan->execute(a);
+
+    for (int k = 0; k < FFTPlan::len; k++) {
+        points[k] = mul(std::conj(a[k]), FFTPlan::chirp[k]);
+    } // for
+}
+
+RealFFTPlan::RealFFTPlan(int len, FFTPlan::Engine engine) :
+len(len), half(len/2 > 0 ? len/2 : 1, engine) {
+    if (len < 2 || len % 2 != 0) {
+        throw std::invalid_argument("RealFFTPlan: length must be even, and at least 2");
+    } // if
+
+    RealFFTPlan::twiddles.resize(len/4 + 1);
+
+    for (int k = 0; k <= len/4; k++) {
+        double angle = -(2*M_PI*k)/len;
+        RealFFTPlan::twiddles[k] = twiddle(angle);
+    } // for
+}
+
+RealFFTPlan::~RealFFTPlan() {}
+
+int RealFFTPlan::getFFTLen() const {
+    return RealFFTPlan::len;
+}
+
+int RealFFTPlan::getBinCount() const {
+    return RealFFTPlan::len/2 + 1;
+}
+
+void RealFFTPlan::execute(const float *points, std::complex<float> *bins) const {
+    // pack z[m] = x[2m] + j x[2m+1], and take its half length FFT
+    memmove((void*) bins, points, RealFFTPlan::len * sizeof(float));
+    RealFFTPlan::half.execute(bins);
+
+    RealFFTPlan::separate(bins);
+}
+
+void RealFFTPlan::executeBatch(const float *points, int pointStride, std::complex<float> *bins, int binStride, int count) const {
+    for (int f = 0; f < count; f++) {
+        memmove((void*) (bins + f*binStride), points + f*pointStride, RealFFTPlan::len * sizeof(float));
+    } // for
+
+    RealFFTPlan::half.executeBatch(bins, count, binStride);
+
+    for (int f = 0; f < count; f++) {
+        RealFFTPlan::separate(bins + f*binStride);
+    } // for
+}
+
+void RealFFTPlan::separate(std::complex<float> *bins) const {
+    int halfLen = RealFFTPlan::len/2;
+
+    // the DC and Nyquist bins are both real
+    std::complex<float> z0 = bins[0];
+    bins[0] = std::complex<float>(z0.real() + z0.imag(), 0);
+    bins[halfLen] = std::complex<float>(z0.real() - z0.imag(), 0);
+
+    // separate the spectra of the even (e) and odd (o) samples from
+    // Z[k] and Z[len/2-k], then X[k] = e + W^k o and X[len/2-k] = conj(e - W^k o)
+    for (int k = 1; k <= halfLen/2; k++) {
+        std::complex<float> zk = bins[k];
+        std::complex<float> zc = std::conj(bins[halfLen - k]);
+
+        std::complex<float> e = (zk + zc) * 0.5f;
+        std::complex<float> d = (zk - zc) * 0.5f;
+        // o = -j * d
+        std::complex<float> o(d.imag(), -d.real());
+
+        std::complex<float> w = RealFFTPlan::twiddles[k];
+        std::complex<float> wo(w.real() * o.real() - w.imag() * o.imag(),
+                               w.real() * o.imag() + w.imag() * o.real());
+
+        bins[k] = e + wo;
+        if (k != halfLen - k) {
+            bins[halfLen - k] = std::conj(e - wo);
+        } // if
+    } // for
+}
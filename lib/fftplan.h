@@ -0,0 +1,192 @@
+#ifndef FFTPLAN_H
+#define FFTPLAN_H
+
+#include <complex>
+#include <vector>
+#include <memory>
+
+class FFTPlan {
+    public:
+        /**
+         * @brief Butterfly engines a plan can execute with. AUTO picks
+         * the engine per size, the others force a given engine. RADIX_2,
+         * RADIX_4 and SPLIT_RADIX need a power of two length, MIXED_RADIX
+         * a length with no prime factors above 7, and BLUESTEIN takes any length.
+         */
+        enum Engine { AUTO, RADIX_2, RADIX_4, SPLIT_RADIX, MIXED_RADIX, BLUESTEIN };
+
+        /**
+         * @brief Construct a new FFT plan. The twiddle factors and the bit-reversal
+         * permutation for the given length are computed once here, so a plan can be
+         * created once per size and executed repeatedly without any allocation.
+         *
+         * Lengths that are not a power of two are factored into radix 2, 3, 4, 5
+         * and 7 stages, and lengths with larger prime factors fall back to the
+         * Bluestein chirp-z algorithm on a power of two FFT of at least 2*len - 1.
+         * Those plans keep a work buffer, so one plan must not be executed
+         * from several threads at once.
+         *
+         * @param len Length of the FFT
+         * @param engine Butterfly engine used to execute the plan
+         */
+        FFTPlan(int len, Engine engine=AUTO);
+
+        ~FFTPlan();
+
+        /**
+         * @brief Gets the plans FFT length
+         *
+         * @return int
+         */
+        int getFFTLen() const;
+
+        /**
+         * @brief Gets the engine the plan executes with. Never AUTO, as
+         * the engine is resolved when the plan is constructed.
+         *
+         * @return Engine
+         */
+        Engine getEngine() const;
+
+        /**
+         * @brief Computes the FFT of a sequence in place with the plans engine.
+         * The butterfly stages run on the vectorized kernels selected by Simd.
+         *
+         * @param points Sequence of getFFTLen() values to transform
+         */
+        void execute(std::complex<float> *points) const;
+
+        /**
+         * @brief Computes the FFTs of count equal length frames in place. Each
+         * butterfly stage is run over every frame before the next stage, so the
+         * stages twiddles are loaded once per batch rather than once per frame,
+         * and frames packed back to back (stride == getFFTLen()) are swept as
+         * a single sequence.
+         *
+         * @param points First frame
+         * @param count Number of frames
+         * @param stride Distance between the start of consecutive frames, at least getFFTLen()
+         */
+        void executeBatch(std::complex<float> *points, int count, int stride) const;
+
+        /**
+         * @brief Computes the inverse FFT of a sequence in place. The result
+         * is not normalised, i.e. it is len times the inverse DFT.
+         *
+         * @param points Sequence of getFFTLen() values to transform
+         */
+        void executeInverse(std::complex<float> *points) const;
+
+        /**
+         * @brief Get the contiguous twiddle factors W_n^i (i < n/2) used by
+         * the n point butterfly stage of a power of two plan
+         *
+         * @param n Length of the butterfly
+         * @return const std::complex<float>*
+         */
+        const std::complex<float> *getTwiddles(int n) const;
+
+        /**
+         * @brief Get the contiguous twiddle factors W_n^3k (k < n/4) used by
+         * the n point radix-4 and split-radix stages of a power of two plan
+         *
+         * @param n Length of the butterfly, at least 4
+         * @return const std::complex<float>*
+         */
+        const std::complex<float> *getTwiddles3(int n) const;
+
+        /**
+         * @brief Get the bit-reversal permutation table of a power of two plan,
+         * where index i of the input is moved to index getBitReverse()[i]
+         *
+         * @return const int*
+         */
+        const int *getBitReverse() const;
+
+    private:
+        void initPowerOfTwo();
+        void initMixedRadix();
+        void initBluestein();
+        void mixedRadix(std::complex<float> *out, const std::complex<float> *in, int stride, const int *factor) const;
+        void executeBluestein(std::complex<float> *points) const;
+        void bitReversePermute(std::complex<float> *points) const;
+        void fourPointStage(std::complex<float> *points, int count) const;
+        void executeRadix2(std::complex<float> *points, int count, int stride) const;
+        void executeRadix4(std::complex<float> *points, int count, int stride) const;
+        void splitRadix(std::complex<float> *points, int n) const;
+
+        int len;
+        Engine engine;
+        // twiddles of the n point stage are stored at offset n/2 - 1
+        std::vector<std::complex<float>> twiddles;
+        // W_n^3k of the n point stage are stored at offset n/4 - 1
+        std::vector<std::complex<float>> twiddles3;
+        std::vector<int> bitReverse;
+        // (radix, remaining length) pairs of each mixed-radix stage
+        std::vector<int> factors;
+        // Bluestein chirp, and the spectrum of its conjugate
+        std::vector<std::complex<float>> chirp;
+        std::vector<std::complex<float>> chirpSpectrum;
+        std::shared_ptr<FFTPlan> convPlan;
+        mutable std::vector<std::complex<float>> scratch;
+};
+
+class RealFFTPlan {
+    public:
+        /**
+         * @brief Construct a new real-input FFT plan. The len real samples are
+         * packed as len/2 complex values into a half length FFTPlan, and separated
+         * by a twiddle pass afterwards, which roughly halves the work of a complex FFT.
+         *
+         * @param len Length of the FFT. Must be even, and at least 2.
+         * @param engine Butterfly engine used by the half length plan
+         */
+        RealFFTPlan(int len, FFTPlan::Engine engine=FFTPlan::AUTO);
+
+        ~RealFFTPlan();
+
+        /**
+         * @brief Gets the plans FFT length
+         *
+         * @return int
+         */
+        int getFFTLen() const;
+
+        /**
+         * @brief Gets the number of non-redundant bins, len/2 + 1
+         *
+         * @return int
+         */
+        int getBinCount() const;
+
+        /**
+         * @brief Computes the FFT of a real sequence, returning only the bins
+         * 0..len/2, as the others are their complex conjugates. Allocates nothing.
+         *
+         * @param points Sequence of getFFTLen() real values to transform
+         * @param bins Output of getBinCount() values. May share memory with points.
+         */
+        void execute(const float *points, std::complex<float> *bins) const;
+
+        /**
+         * @brief Computes the FFTs of count equal length real frames, each frame
+         * packed into its own output bins as in execute()
+         *
+         * @param points First real frame
+         * @param pointStride Distance between the start of consecutive real frames
+         * @param bins Output bins of the first frame
+         * @param binStride Distance between the output bins of consecutive frames, at least getBinCount()
+         * @param count Number of frames
+         */
+        void executeBatch(const float *points, int pointStride, std::complex<float> *bins, int binStride, int count) const;
+
+    private:
+        void separate(std::complex<float> *bins) const;
+
+        int len;
+        FFTPlan half;
+        // W_len^k for k <= len/4
+        std::vector<std::complex<float>> twiddles;
+};
+
+#endif // FFTPLAN_H
@@ -2,6 +2,8 @@
 #include <cmath>
 #include <vector>
 #include "filter.h"
+#include "filterdesigncache.h"
+#include "peakfinder.h"
 
 using namespace std;
 
@@ -44,6 +46,12 @@ double Filter::bessi0( double x ) {
    return ans;
 }
 
+void Filter::bessi0(const double *x, double *result, int count) {
+    for (int i = 0; i < count; i++) {
+        result[i] = Filter::bessi0(x[i]);
+    } // for
+}
+
 double Filter::kaiserBesselWindowShape(int att) {
     if (att > 50) {
         return 0.1102 * (((double) att) - 8.7);
@@ -55,14 +63,14 @@ double Filter::kaiserBesselWindowShape(int att) {
 }
 
 double* Filter::sincFunction(double fHigh, double fLow, int fs, int len) {
-    double* result = (double*) malloc((len+1)/2 * sizeof(double*));
+    double* result = (double*) malloc((len+1)/2 * sizeof(double));
 
     double fHighFw = fHigh / ((double) fs);
     double fLowFw = fLow / ((double) fs);
 
     *result = ( 2 * (fHigh - fLow)) / (fs);
     
-    for (int i = 1; i <= (len+1)/2; i++) {
+    for (int i = 1; i < (len+1)/2; i++) {
         double temp = ( sin(2*M_PI*i*fHighFw) - sin(2*M_PI*i*fLowFw)) / (M_PI * i);
         *(result + i) = temp;
     } // for
@@ -77,19 +85,24 @@ double * Filter::kaiserBesselFilterCoefficients(int len, double att, double fHig
      * 
      */
 
-    double * result = (double*) malloc(len * sizeof(double*));
+    double * result = (double*) malloc(len * sizeof(double));
     double * sinc = Filter::sincFunction(fHigh, fLow, fs, len);
     int half_len = (len-1)/2;
     double alpha = Filter::kaiserBesselWindowShape(att);
-    //double besselAlpha =  Filter::bessi0(alpha);
-    double besselAlpha2 = Filter::bess_2(alpha);
+    double besselAlpha = Filter::bessi0(alpha);
 
+    // the window is evaluated for all taps at once
+    std::vector<double> bessArg(half_len + 1);
+    std::vector<double> besselI(half_len + 1);
     for (int i = 0; i <= half_len; i++) {
-        double bessArg = alpha * sqrt(1 - ((double)i *i)/((double) half_len * half_len));
-        //double besselI = Filter::bessi0(bessArg);
-        double besselI2 = Filter::bess_2(bessArg);
-        *(result + half_len + i) = (*(sinc + i) * besselI2) / besselAlpha2;
+        bessArg[i] = alpha * sqrt(1 - ((double)i *i)/((double) half_len * half_len));
     } // for
+    Filter::bessi0(&bessArg[0], &besselI[0], half_len + 1);
+
+    for (int i = 0; i <= half_len; i++) {
+        *(result + half_len + i) = (*(sinc + i) * besselI[i]) / besselAlpha;
+    } // for
+    free(sinc);
 
     for (int i = 0; i < half_len; i++) {
         double temp = *(result + len - 1 - i);
@@ -100,11 +113,11 @@ double * Filter::kaiserBesselFilterCoefficients(int len, double att, double fHig
 }
 
 std::vector<std::complex<float>> Filter::complexKaiserBesselFilterCoefficients(int len, double att, double fHigh, double fLow, int fs) {
-    double * result = Filter::kaiserBesselFilterCoefficients(len, att, fHigh, fLow, fs);
+    std::shared_ptr<const std::vector<double>> result = FilterDesignCache::kaiserBessel(len, att, fHigh, fLow, fs);
     std::vector<std::complex<float>> complexResult;
 
     for (int i = 0; i < len; i++) {
-        complexResult.push_back((float) *(result + i));
+        complexResult.push_back((float) (*result)[i]);
     } // for
 
     return complexResult;
@@ -131,20 +144,28 @@ std::vector<std::complex<float>> Filter::complexHammingWindow(int n) {
     return window;
 }
 
-std::vector<std::complex<float>> Filter::applyFilterByConv(std::vector<std::complex<float>> seq, std::vector<std::complex<float>> fil, int seqLen, int filLen) {
-    std::vector<std::complex<float>> output;
-    // loop over each val in ouput
-    for (int n = 0; n < (seqLen + filLen); n++) {
-        std::complex<float> sum = 0;
-        // loop over each val in filter
-        for (int i = 0; i < filLen; i++) {
-            // check filter and sequence array bounds
-            if (((n-i) >= 0) && ((n-i) < seqLen)) {
-                sum += (fil[i] * seq[n-i]);
-            } // else     
-        } // for
-        output.push_back(sum);
-    } // for
+std::vector<std::complex<float>> Filter::applyFilterByConv(const std::vector<std::complex<float>> &seq, const std::vector<std::complex<float>> &fil, int seqLen, int filLen) {
+    std::vector<std::complex<float>> output(seqLen + filLen, std::complex<float>(0, 0));
+    if (seqLen <= 0 || filLen <= 0) {
+        return output;
+    } // if
+
+    Convolver convolver(std::vector<std::complex<float>>(fil.begin(), fil.begin() + filLen));
+
+    // the last value of the len1 + len2 output is always zero
+    convolver.convolve(&seq[0], seqLen, &output[0]);
+
+    return output;
+}
+
+std::vector<std::complex<float>> Filter::applyFilterByConv(const std::vector<std::complex<float>> &seq, int seqLen, const Convolver &convolver) {
+    int filLen = convolver.getFilter().size();
+    std::vector<std::complex<float>> output(seqLen + filLen, std::complex<float>(0, 0));
+    if (seqLen <= 0) {
+        return output;
+    } // if
+
+    convolver.convolve(&seq[0], seqLen, &output[0]);
 
     return output;
 }
@@ -183,4 +204,28 @@ std::vector<float> Filter::getPrinciple(std::vector<std::vector<float>> inp, std
     } // for
 
     return res;
+}
+
+std::vector<float> Filter::getPrinciple(const Spectrogram<float> &inp, const std::vector<float> &arg) {
+    std::vector<float> res;
+
+    for (int i = 0; i < inp.getFrameCount(); i++) {
+        StridedSpan<const float> frame = inp.row(i);
+        float max = frame[0];
+        int argmax = 0;
+        for (int j = 1; j < frame.size(); j++) {
+            if (frame[j] > max) {
+                max = frame[j];
+                argmax = j;
+            }
+        } // for
+        res.push_back(arg[argmax]);
+    } // for
+
+    return res;
+}
+
+std::vector<float> Filter::getPrinciple(const Spectrogram<std::complex<float>> &inp, const std::vector<float> &arg) {
+    PeakFinder finder(arg, 1, PeakFinder::NONE);
+    return finder.getPrinciple(inp);
 }
\ No newline at end of file
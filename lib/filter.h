@@ -3,6 +3,10 @@
 
 #include <complex>
 #include <map>
+#include <memory>
+#include <vector>
+#include "convolver.h"
+#include "spectrogram.h"
 
 class Filter {
     public:
@@ -18,6 +22,18 @@ class Filter {
          */
         double bessi0(double x);
 
+        /**
+         * @brief Evaluates bessi0 over an array. The polynomial approximations
+         * have a fixed cost and a relative error below 2e-7 for every x, unlike
+         * the open ended series of bess_2, and the loop has no dependencies
+         * between values.
+         * 
+         * @param x Positions at which to retrieve the Bessel estimate
+         * @param result Bessel estimates, one per position
+         * @param count Number of positions
+         */
+        void bessi0(const double *x, double *result, int count);
+
         /**
          * @brief Estimate of the modified zero order Bessel function
          * sourced from https://www.arc.id.au/FilterDesign.html
@@ -45,20 +61,21 @@ class Filter {
          * @param fLow Low frequency cutoff (Hz)
          * @param fs Sampling frequency (Hz)
          * @param len Length of sinc function
-         * @return double* 
+         * @return double* of (len+1)/2 values, to be released with free()
          */
         double *sincFunction(double fHigh, double fLow, int fs, int len);
 
         /**
          * @brief Returns the time domain filter coefficients for a Kaiser-Bessel
-         * bandpass filter - adapted from: https://www.arc.id.au/FilterDesign.html
+         * bandpass filter - adapted from: https://www.arc.id.au/FilterDesign.html.
+         * See FilterDesignCache for filters that are designed repeatedly.
          * 
-         * @param len Length of filter
+         * @param len Length of filter, odd
          * @param att Attenuation (dB) in side lobes
          * @param fHigh High frequency cutoff (Hz)
          * @param fLow Low frequency cutoff (Hz)
          * @param fs Sampling frequency (Hz)
-         * @return double* 
+         * @return double* of len values, to be released with free()
          */
         double *kaiserBesselFilterCoefficients(int len,double att, double fHigh, double fLow, int fs);
 
@@ -103,7 +120,11 @@ class Filter {
         double *applyFilterByConv(double * seq, double * fil, int seqLen, int filLen);
 
         /**
-         * @brief Convolves two signals to produce another of length len1+ len2
+         * @brief Convolves two signals to produce another of length len1+ len2.
+         * Short filters are convolved directly, and longer ones by overlap-save
+         * FFT convolution (see Convolver). The spectrum of the filter is
+         * computed on every call, so pass a Convolver built once to filter
+         * many sequences with the same filter.
          * 
          * @param seq First sequence to convolve
          * @param fil Second sequence to convolve
@@ -111,7 +132,18 @@ class Filter {
          * @param filLen Second sequence length
          * @return std::vector<std::complex<float>> 
          */
-        std::vector<std::complex<float>> applyFilterByConv(std::vector<std::complex<float>> seq, std::vector<std::complex<float>> fil, int seqLen, int filLen);
+        std::vector<std::complex<float>> applyFilterByConv(const std::vector<std::complex<float>> &seq, const std::vector<std::complex<float>> &fil, int seqLen, int filLen);
+
+        /**
+         * @brief Convolves a signal with the filter of a Convolver to produce
+         * another of length len1+ len2, reusing the filter spectrum it holds
+         * 
+         * @param seq Sequence to convolve
+         * @param seqLen Sequence length
+         * @param convolver Convolver of the filter
+         * @return std::vector<std::complex<float>> 
+         */
+        std::vector<std::complex<float>> applyFilterByConv(const std::vector<std::complex<float>> &seq, int seqLen, const Convolver &convolver);
 
         /**
          * @brief Get the principle frequency (argmax) given a 2d STFT and the
@@ -122,6 +154,29 @@ class Filter {
          * @return std::vector<float> 
          */
         std::vector<float> getPrinciple(std::vector<std::vector<float>> inp, std::vector<float> arg);
+
+        /**
+         * @brief Get the principle frequency (argmax) of each frame of a
+         * spectrogram, read in place
+         * 
+         * @param inp Magnitude spectrogram
+         * @param arg Frequency Bins
+         * @return std::vector<float> 
+         */
+        std::vector<float> getPrinciple(const Spectrogram<float> &inp, const std::vector<float> &arg);
+
+        /**
+         * @brief Get the principle frequency (argmax) of each frame of a complex
+         * spectrogram. This forwards to PeakFinder(arg, 1, PeakFinder::NONE),
+         * which finds peaks for all callers; use PeakFinder directly for more
+         * peaks and sub-bin interpolation.
+         * 
+         * @param inp Complex spectrogram, e.g. STFT::getSpectrogram
+         * @param arg Frequency Bins
+         * @return std::vector<float> 
+         */
+        std::vector<float> getPrinciple(const Spectrogram<std::complex<float>> &inp, const std::vector<float> &arg);
+
 };
 
 #endif // FILTER_H
\ No newline at end of file
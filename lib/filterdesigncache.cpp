@@ -0,0 +1,51 @@
+#include <cstdlib>
+#include <stdexcept>
+#include "filterdesigncache.h"
+#include "filter.h"
+
+using namespace std;
+
+std::mutex FilterDesignCache::mutex;
+std::map<FilterDesignCache::Key, std::shared_ptr<const std::vector<double>>> FilterDesignCache::designs;
+
+bool FilterDesignCache::Key::operator<(const Key &other) const {
+    if (len != other.len) {
+        return len < other.len;
+    } else if (att != other.att) {
+        return att < other.att;
+    } else if (fHigh != other.fHigh) {
+        return fHigh < other.fHigh;
+    } else if (fLow != other.fLow) {
+        return fLow < other.fLow;
+    } // else
+    return fs < other.fs;
+}
+
+std::shared_ptr<const std::vector<double>> FilterDesignCache::kaiserBessel(int len, double att, double fHigh, double fLow, int fs) {
+    if (len <= 0) {
+        throw std::invalid_argument("FilterDesignCache: the filter length must be positive");
+    } // if
+
+    Key key = { len, att, fHigh, fLow, fs };
+
+    std::lock_guard<std::mutex> lock(FilterDesignCache::mutex);
+    std::shared_ptr<const std::vector<double>> &design = FilterDesignCache::designs[key];
+    if (!design) {
+        Filter filter;
+        double *result = filter.kaiserBesselFilterCoefficients(len, att, fHigh, fLow, fs);
+        design = std::make_shared<const std::vector<double>>(result, result + len);
+        free(result);
+    } // if
+
+    return design;
+}
+
+int FilterDesignCache::size() {
+    std::lock_guard<std::mutex> lock(FilterDesignCache::mutex);
+    return FilterDesignCache::designs.size();
+}
+
+void FilterDesignCache::clear() {
+    std::lock_guard<std::mutex> lock(FilterDesignCache::mutex);
+    FilterDesignCache::designs.clear();
+}
@@ -0,0 +1,54 @@
+#ifndef FILTERDESIGNCACHE_H
+#define FILTERDESIGNCACHE_H
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+class FilterDesignCache {
+    public:
+        /**
+         * @brief Gets the coefficients of a Kaiser-Bessel bandpass filter, see
+         * Filter::kaiserBesselFilterCoefficients. Each design is computed once,
+         * and the same immutable coefficients are shared by every caller asking
+         * for it, so retuning between known bands costs a lookup.
+         *
+         * @param len Length of filter, odd
+         * @param att Attenuation (dB) in side lobes
+         * @param fHigh High frequency cutoff (Hz)
+         * @param fLow Low frequency cutoff (Hz)
+         * @param fs Sampling frequency (Hz)
+         * @return std::shared_ptr<const std::vector<double>> of len coefficients
+         */
+        static std::shared_ptr<const std::vector<double>> kaiserBessel(int len, double att, double fHigh, double fLow, int fs);
+
+        /**
+         * @brief Gets the number of cached designs
+         *
+         * @return int
+         */
+        static int size();
+
+        /**
+         * @brief Releases every cached design. Coefficients still in use stay valid.
+         *
+         */
+        static void clear();
+
+    private:
+        struct Key {
+            int len;
+            double att;
+            double fHigh;
+            double fLow;
+            int fs;
+
+            bool operator<(const Key &other) const;
+        };
+
+        static std::mutex mutex;
+        static std::map<Key, std::shared_ptr<const std::vector<double>>> designs;
+};
+
+#endif // FILTERDESIGNCACHE_H
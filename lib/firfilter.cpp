@@ -0,0 +1,136 @@
+#include <complex>
+#include <memory>
+#include <algorithm>
+#include <stdexcept>
+#include "firfilter.h"
+#include "filterdesigncache.h"
+#include "simd.h"
+
+using namespace std;
+
+template <typename T>
+FirFilter<T>::FirFilter(const std::vector<float> &coeffs) : coeffs(coeffs) {
+    FirFilter::init();
+}
+
+template <typename T>
+FirFilter<T>::FirFilter(int len, double att, double fHigh, double fLow, int fs) {
+    std::shared_ptr<const std::vector<double>> design = FilterDesignCache::kaiserBessel(len, att, fHigh, fLow, fs);
+    FirFilter::coeffs.assign(design->begin(), design->end());
+
+    FirFilter::init();
+}
+
+template <typename T>
+FirFilter<T>::~FirFilter() { }
+
+template <typename T>
+void FirFilter<T>::init() {
+    if (FirFilter::coeffs.empty()) {
+        throw std::invalid_argument("FirFilter: no coefficients");
+    } // if
+
+    int len = FirFilter::coeffs.size();
+
+    FirFilter::symmetric = true;
+    for (int i = 0; i < len/2; i++) {
+        if (FirFilter::coeffs[i] != FirFilter::coeffs[len - 1 - i]) {
+            FirFilter::symmetric = false;
+        } // if
+    } // for
+
+    FirFilter::reversed.assign(FirFilter::coeffs.rbegin(), FirFilter::coeffs.rend());
+    FirFilter::delay.resize(2 * len);
+    FirFilter::work.resize(len - 1 + FirFilter::blockLen);
+    FirFilter::reset();
+}
+
+template <typename T>
+void FirFilter<T>::reset() {
+    std::fill(FirFilter::delay.begin(), FirFilter::delay.end(), T(0));
+    FirFilter::pos = 0;
+}
+
+template <typename T>
+int FirFilter<T>::getLen() const {
+    return FirFilter::coeffs.size();
+}
+
+template <typename T>
+const std::vector<float> &FirFilter<T>::getCoefficients() const {
+    return FirFilter::coeffs;
+}
+
+template <typename T>
+bool FirFilter<T>::isSymmetric() const {
+    return FirFilter::symmetric;
+}
+
+template <typename T>
+void FirFilter<T>::push(T sample) {
+    int len = FirFilter::coeffs.size();
+
+    // the newest sample replaces the oldest
+    FirFilter::pos = FirFilter::pos + 1 < len ? FirFilter::pos + 1 : 0;
+    FirFilter::delay[FirFilter::pos] = sample;
+    FirFilter::delay[FirFilter::pos + len] = sample;
+}
+
+template <typename T>
+T FirFilter<T>::process(T sample) {
+    int len = FirFilter::coeffs.size();
+    FirFilter::push(sample);
+
+    // delay[pos + 1 .. pos + len] runs from the oldest to the newest sample
+    const T *window = &FirFilter::delay[FirFilter::pos + 1];
+    const float *taps = &FirFilter::reversed[0];
+
+    T sum = T(0);
+    for (int i = 0; i < len; i++) {
+        sum += window[i] * taps[i];
+    } // for
+
+    return sum;
+}
+
+template <typename T>
+void FirFilter<T>::process(const T *input, T *output, int count) {
+    if (!FirFilter::symmetric) {
+        for (int n = 0; n < count; n++) {
+            output[n] = FirFilter::process(input[n]);
+        } // for
+        return;
+    } // if
+
+    int len = FirFilter::coeffs.size();
+    int block = FirFilter::blockLen;
+
+    while (count > 0) {
+        int n = std::min(count, block);
+
+        // the last len - 1 samples, delay[pos + 2 .. pos + len], are followed
+        // by the block, so the kernel runs over one contiguous buffer
+        const T *history = FirFilter::delay.data() + FirFilter::pos + 2;
+        std::copy(history, history + len - 1, FirFilter::work.begin());
+        std::copy(input, input + n, FirFilter::work.begin() + len - 1);
+
+        Simd::symmetricFir(&FirFilter::work[0], &FirFilter::coeffs[0], len, output, n);
+
+        // the end of the block becomes the delay line
+        for (int i = std::max(0, n - len); i < n; i++) {
+            FirFilter::push(FirFilter::work[len - 1 + i]);
+        } // for
+
+        input += n;
+        output += n;
+        count -= n;
+    } // while
+}
+
+template <typename T>
+void FirFilter<T>::process(T *samples, int count) {
+    FirFilter::process(samples, samples, count);
+}
+
+template class FirFilter<float>;
+template class FirFilter<std::complex<float>>;
@@ -0,0 +1,114 @@
+#ifndef FIRFILTER_H
+#define FIRFILTER_H
+
+#include <complex>
+#include <vector>
+
+/**
+ * @brief A streaming FIR filter with real coefficients. The last len - 1
+ * input samples are kept in a circular delay line between calls, so a stream
+ * filtered block by block, in blocks of any size, gives exactly the output
+ * of filtering it in one go, and each output is available as soon as its
+ * input sample is.
+ *
+ * @tparam T Sample type, float or std::complex<float>
+ */
+template <typename T>
+class FirFilter {
+    public:
+        /**
+         * @brief Construct a new FirFilter object from its coefficients
+         *
+         * @param coeffs Filter coefficients (impulse response)
+         */
+        FirFilter(const std::vector<float> &coeffs);
+
+        /**
+         * @brief Construct a new FirFilter object as a Kaiser-Bessel bandpass filter,
+         * see Filter::kaiserBesselFilterCoefficients
+         *
+         * @param len Length of filter
+         * @param att Attenuation (dB) in side lobes
+         * @param fHigh High frequency cutoff (Hz)
+         * @param fLow Low frequency cutoff (Hz)
+         * @param fs Sampling frequency (Hz)
+         */
+        FirFilter(int len, double att, double fHigh, double fLow, int fs);
+
+        ~FirFilter();
+
+        /**
+         * @brief Filters a block of samples, continuing from the previous block
+         *
+         * @param input Input samples
+         * @param output Output samples, which may be the same buffer as input
+         * @param count Number of samples
+         */
+        void process(const T *input, T *output, int count);
+
+        /**
+         * @brief Filters a block of samples in place, continuing from the previous block
+         *
+         * @param samples
+         * @param count Number of samples
+         */
+        void process(T *samples, int count);
+
+        /**
+         * @brief Filters a single sample
+         *
+         * @param sample
+         * @return T
+         */
+        T process(T sample);
+
+        /**
+         * @brief Clears the delay line, as if the filter had only seen zeros
+         *
+         */
+        void reset();
+
+        /**
+         * @brief Gets the number of coefficients
+         *
+         * @return int
+         */
+        int getLen() const;
+
+        /**
+         * @brief Gets the filter coefficients
+         *
+         * @return const std::vector<float>&
+         */
+        const std::vector<float> &getCoefficients() const;
+
+        /**
+         * @brief Checks if the coefficients are symmetric (linear phase), in which
+         * case blocks are filtered by a vectorized kernel that folds the taps
+         *
+         * @return true if symmetric
+         */
+        bool isSymmetric() const;
+
+    private:
+        void init();
+        void push(T sample);
+
+        // samples filtered at a time by block processing
+        static const int blockLen = 256;
+
+        std::vector<float> coeffs;
+        // coefficients in reverse, to run forwards over the delay line
+        std::vector<float> reversed;
+        bool symmetric;
+
+        // each sample is written at pos and pos + len, so the last
+        // len samples are always contiguous from pos + 1
+        std::vector<T> delay;
+        int pos;
+
+        // the delay line followed by a block of input
+        std::vector<T> work;
+};
+
+#endif // FIRFILTER_H
@@ -0,0 +1,101 @@
+#ifndef FRAMEITERATOR_H
+#define FRAMEITERATOR_H
+
+#include <algorithm>
+
+/**
+ * @brief Steps a frame of frameLen samples through a signal by hopLen samples
+ * at a time, and writes each frame windowed and zero padded straight from the
+ * source buffer into the callers buffer, so frames are never copied on their own.
+ * Overlapping frames (hopLen < frameLen) share the source samples.
+ *
+ * @tparam T Sample type, e.g. float or std::complex<float>
+ */
+template <typename T>
+class FrameIterator {
+    public:
+        /**
+         * @brief Construct a new FrameIterator object
+         *
+         * @param signal Source signal, which must outlive the iterator
+         * @param signalLen Length of the source signal
+         * @param frameLen Number of samples in each frame
+         * @param hopLen Number of samples between the start of consecutive frames
+         * @param window Real window coefficients of at least frameLen values, or 0 for none
+         * @param outLen Length of each output frame. Samples past frameLen are zero padded.
+         */
+        FrameIterator(const T *signal, int signalLen, int frameLen, int hopLen, const float *window, int outLen) :
+        signal(signal), signalLen(signalLen), frameLen(frameLen), hopLen(hopLen), window(window), outLen(outLen), position(0) {}
+
+        /**
+         * @brief Gets the number of whole frames in the signal
+         *
+         * @return int
+         */
+        int getFrameCount() const {
+            if (FrameIterator::signalLen < FrameIterator::frameLen || FrameIterator::hopLen <= 0) {
+                return 0;
+            } // if
+
+            return (FrameIterator::signalLen - FrameIterator::frameLen) / FrameIterator::hopLen + 1;
+        }
+
+        /**
+         * @brief Gets the index of the next frame returned by next()
+         *
+         * @return int
+         */
+        int getPosition() const {
+            return FrameIterator::position;
+        }
+
+        /**
+         * @brief Writes the next frame into dest and advances by one hop
+         *
+         * @param dest Output of outLen samples
+         * @return true if a frame was written, false at the end of the signal
+         */
+        bool next(T *dest) {
+            if (FrameIterator::position >= FrameIterator::getFrameCount()) {
+                return false;
+            } // if
+
+            FrameIterator::frame(FrameIterator::position, dest);
+            FrameIterator::position++;
+
+            return true;
+        }
+
+        /**
+         * @brief Writes the frame at a given index into dest, without moving
+         * the iterator. Frames can be written from several threads at once.
+         *
+         * @param index Frame index, less than getFrameCount()
+         * @param dest Output of outLen samples
+         */
+        void frame(int index, T *dest) const {
+            const T *src = FrameIterator::signal + (long long) index * FrameIterator::hopLen;
+            int copyLen = std::min(FrameIterator::frameLen, FrameIterator::outLen);
+
+            if (FrameIterator::window) {
+                for (int i = 0; i < copyLen; i++) {
+                    dest[i] = src[i] * FrameIterator::window[i];
+                } // for
+            } else {
+                std::copy(src, src + copyLen, dest);
+            } // else
+
+            std::fill(dest + copyLen, dest + FrameIterator::outLen, T(0));
+        }
+
+    private:
+        const T *signal;
+        int signalLen;
+        int frameLen;
+        int hopLen;
+        const float *window;
+        int outLen;
+        int position;
+};
+
+#endif // FRAMEITERATOR_H
@@ -0,0 +1,237 @@
+#include <complex>
+#include <cmath>
+#include <algorithm>
+#include <stdexcept>
+#include "goertzelbank.h"
+#include "frameiterator.h"
+#include "windowcache.h"
+
+using namespace std;
+
+GoertzelBank::GoertzelBank(int windowLen, int samplingFreq, int fftLen, const std::vector<int> &bins, std::string window, int hopLen) :
+windowLen(windowLen), samplingFreq(samplingFreq), fftLen(fftLen), bins(bins) {
+    GoertzelBank::hopLen = hopLen > 0 ? hopLen : fftLen;
+
+    WindowCache::Type type = WindowCache::parseType(window);
+    if (type != WindowCache::RECTANGULAR) {
+        GoertzelBank::windowCoeffs = WindowCache::get(type, fftLen+1, WindowCache::defaultKaiserBeta);
+    } // if
+
+    int len = std::min(fftLen, windowLen);
+    for (int i = 0; i < bins.size(); i++) {
+        if (bins[i] < 0 || bins[i] >= windowLen) {
+            throw std::invalid_argument("GoertzelBank: bin out of range");
+        } // if
+
+        double w = 2 * M_PI * bins[i] / windowLen;
+        GoertzelBank::coeffs.push_back((float) (2 * cos(w)));
+        GoertzelBank::rotations.push_back(std::polar(1.0f, (float) -w));
+        GoertzelBank::phases.push_back(std::polar(1.0f, (float) (-w * (len - 1))));
+        GoertzelBank::freqBins.push_back(bins[i] * ((float) samplingFreq / windowLen));
+    } // for
+
+    /**
+     * A window c0 + c1 cos(x) + ... + c(T-1) cos((T-1)x), x = 2*pi*n/(fftLen + 1),
+     * times e^-jwn is the sum over t = -(T-1)..T-1 of c|t| (halved for t != 0)
+     * times e^-j(w - 2*pi*t/(fftLen + 1))n, so each windowed bin is a weighted
+     * sum of 2T - 1 unwindowed ones. Each of those slides by one sample as
+     * R <- e^jv (R - x[m]) + x[m + len] e^-jv(len - 1).
+     */
+    std::vector<double> cosineTerms = WindowCache::getCosineTerms(type);
+    GoertzelBank::terms = 2 * cosineTerms.size() - 1;
+    GoertzelBank::sliding = !cosineTerms.empty() && GoertzelBank::hopLen < len &&
+        GoertzelBank::slideCost() < GoertzelBank::recomputeCost();
+
+    if (GoertzelBank::sliding) {
+        int half = cosineTerms.size() - 1;
+        for (int i = 0; i < bins.size(); i++) {
+            for (int t = -half; t <= half; t++) {
+                double v = 2 * M_PI * bins[i] / windowLen - 2 * M_PI * t / (fftLen + 1);
+                GoertzelBank::slideWeights.push_back(t == 0 ? cosineTerms[0] : cosineTerms[std::abs(t)] / 2);
+                GoertzelBank::slideRotations.push_back(std::polar(1.0, v));
+                GoertzelBank::slideTails.push_back(std::polar(1.0, -v * (len - 1)));
+            } // for
+        } // for
+    } // if
+}
+
+GoertzelBank::~GoertzelBank() { }
+
+std::vector<int> GoertzelBank::binsAround(float freq, int count, int windowLen, int samplingFreq) {
+    int centre = (int) std::floor(freq * windowLen / samplingFreq + 0.5f);
+    int first = std::max(0, std::min(centre - count/2, windowLen - count));
+
+    std::vector<int> bins;
+    for (int i = 0; i < count && first + i < windowLen; i++) {
+        bins.push_back(first + i);
+    } // for
+
+    return bins;
+}
+
+double GoertzelBank::fftCost() const {
+    // about 5 N log2(N) flops for an N point complex FFT
+    return 5.0 * GoertzelBank::windowLen * std::log2((double) GoertzelBank::windowLen);
+}
+
+double GoertzelBank::recomputeCost() const {
+    // 2 multiplies and 4 adds per complex sample and bin
+    return 6.0 * GoertzelBank::bins.size() * std::min(GoertzelBank::fftLen, GoertzelBank::windowLen);
+}
+
+double GoertzelBank::slideCost() const {
+    // a complex multiply, a complex by real multiply and 4 adds per sample and sum
+    return 14.0 * GoertzelBank::bins.size() * GoertzelBank::terms * GoertzelBank::hopLen;
+}
+
+bool GoertzelBank::isCheaperThanFFT() const {
+    double cost = GoertzelBank::sliding ? GoertzelBank::slideCost() : GoertzelBank::recomputeCost();
+    return cost < GoertzelBank::fftCost();
+}
+
+void GoertzelBank::computeSTFT(std::vector<std::complex<float>> *signal) {
+    GoertzelBank::compute((*signal).empty() ? 0 : &(*signal)[0], (*signal).size());
+}
+
+void GoertzelBank::computeSTFT(std::vector<float> *signal) {
+    GoertzelBank::compute((*signal).empty() ? 0 : &(*signal)[0], (*signal).size());
+}
+
+template <typename T>
+void GoertzelBank::compute(const T *signal, int signalLen) {
+    FrameIterator<T> frameIt(signal, signalLen, GoertzelBank::fftLen, GoertzelBank::hopLen, 0, 0);
+    int numFrames = frameIt.getFrameCount();
+
+    GoertzelBank::timeBins.clear();
+    for (int f = 0; f < numFrames; f++) {
+        GoertzelBank::timeBins.push_back(((float) f * GoertzelBank::hopLen)/(GoertzelBank::samplingFreq));
+    } // for
+
+    GoertzelBank::result.resize(numFrames, GoertzelBank::bins.size());
+
+    if (GoertzelBank::sliding) {
+        GoertzelBank::slide(signal, numFrames);
+    } else {
+        GoertzelBank::recompute(signal, signalLen, numFrames);
+    } // else
+}
+
+template <typename T>
+void GoertzelBank::recompute(const T *signal, int signalLen, int numFrames) {
+    int len = std::min(GoertzelBank::fftLen, GoertzelBank::windowLen);
+    int count = GoertzelBank::bins.size();
+    const float *window = GoertzelBank::windowCoeffs ? GoertzelBank::windowCoeffs->data() : 0;
+
+    // the zero padding adds nothing to the sums, so only len samples are run
+    FrameIterator<T> frameIt(signal, signalLen, GoertzelBank::fftLen, GoertzelBank::hopLen, window, len);
+
+    std::vector<T> frame(len);
+    std::vector<T> s1(count);
+    std::vector<T> s2(count);
+    const float *c = GoertzelBank::coeffs.empty() ? 0 : &GoertzelBank::coeffs[0];
+
+    for (int f = 0; f < numFrames; f++) {
+        frameIt.frame(f, &frame[0]);
+        std::fill(s1.begin(), s1.end(), T(0));
+        std::fill(s2.begin(), s2.end(), T(0));
+
+        // s[n] = x[n] + 2cos(w) s[n-1] - s[n-2], with the bins side by side
+        for (int n = 0; n < len; n++) {
+            T x = frame[n];
+            for (int k = 0; k < count; k++) {
+                T s0 = x + c[k] * s1[k] - s2[k];
+                s2[k] = s1[k];
+                s1[k] = s0;
+            } // for
+        } // for
+
+        // X(w) = e^-jw(len-1) (s[len-1] - e^-jw s[len-2])
+        for (int k = 0; k < count; k++) {
+            std::complex<float> last(s1[k]);
+            std::complex<float> before(s2[k]);
+            GoertzelBank::result(f, k) = GoertzelBank::phases[k] * (last - GoertzelBank::rotations[k] * before);
+        } // for
+    } // for
+}
+
+template <typename T>
+void GoertzelBank::slide(const T *signal, int numFrames) {
+    if (numFrames == 0) {
+        return;
+    } // if
+
+    int len = std::min(GoertzelBank::fftLen, GoertzelBank::windowLen);
+    int count = GoertzelBank::bins.size();
+    int sums = count * GoertzelBank::terms;
+    const std::complex<double> *rot = GoertzelBank::slideRotations.data();
+    const std::complex<double> *tail = GoertzelBank::slideTails.data();
+
+    // the first frame is summed directly, in double precision as the sums
+    // carry their rounding from frame to frame
+    std::vector<std::complex<double>> state(sums, 0.0);
+    for (int i = 0; i < sums; i++) {
+        std::complex<double> step = std::conj(rot[i]);
+        std::complex<double> phasor = 1;
+        for (int n = 0; n < len; n++) {
+            state[i] += std::complex<double>(signal[n]) * phasor;
+            phasor *= step;
+        } // for
+    } // for
+
+    for (int f = 0; f < numFrames; f++) {
+        if (f > 0) {
+            for (long long m = (long long) (f - 1) * GoertzelBank::hopLen; m < (long long) f * GoertzelBank::hopLen; m++) {
+                std::complex<double> leaving(signal[m]);
+                std::complex<double> entering(signal[m + len]);
+                for (int i = 0; i < sums; i++) {
+                    state[i] = rot[i] * (state[i] - leaving) + entering * tail[i];
+                } // for
+            } // for
+        } // if
+
+        for (int k = 0; k < count; k++) {
+            std::complex<double> sum = 0;
+            for (int t = 0; t < GoertzelBank::terms; t++) {
+                int i = k * GoertzelBank::terms + t;
+                sum += GoertzelBank::slideWeights[i] * state[i];
+            } // for
+            GoertzelBank::result(f, k) = std::complex<float>(sum);
+        } // for
+    } // for
+}
+
+const Spectrogram<std::complex<float>> &GoertzelBank::getSpectrogram() const {
+    return GoertzelBank::result;
+}
+
+Spectrogram<float> GoertzelBank::getMagSpectrogram() const {
+    Spectrogram<float> mag(GoertzelBank::result.getFrameCount(), GoertzelBank::result.getBinCount());
+    for (int i = 0; i < GoertzelBank::result.getFrameCount(); i++) {
+        for (int j = 0; j < GoertzelBank::result.getBinCount(); j++) {
+            mag(i, j) = std::abs(GoertzelBank::result(i, j));
+        } // for
+    } // for
+
+    return mag;
+}
+
+std::vector<std::vector<float>> GoertzelBank::getMagResult() {
+    std::vector<std::vector<float>> abs;
+    for (int i = 0; i < GoertzelBank::result.getFrameCount(); i++) {
+        std::vector<float> abs_vec;
+        for (int j = 0; j < GoertzelBank::result.getBinCount(); j++) {
+            abs_vec.push_back(std::abs(GoertzelBank::result(i, j)));
+        } // for
+        abs.push_back(abs_vec);
+    } // for
+
+    return abs;
+}
+
+std::vector<float> GoertzelBank::getFreqBins() {
+    return GoertzelBank::freqBins;
+}
+
+std::vector<float> GoertzelBank::getTimeBins() {
+    return GoertzelBank::timeBins;
+}
@@ -0,0 +1,154 @@
+#ifndef GOERTZELBANK_H
+#define GOERTZELBANK_H
+
+#include <complex>
+#include <memory>
+#include <string>
+#include <vector>
+#include "alignedbuffer.h"
+#include "spectrogram.h"
+
+class GoertzelBank {
+    public:
+        /**
+         * @brief Construct a new GoertzelBank object, which computes a chosen subset
+         * of the bins of an STFT with the same parameters, by running one Goertzel
+         * recursion per bin over each frame. Each sample costs O(bins) work rather
+         * than the O(log windowLen) per bin of a full FFT, so it is cheaper when only
+         * a few bins, e.g. those near a known carrier, are needed.
+         *
+         * When frames overlap, a window that is a sum of T cosines (all but Kaiser)
+         * is split into 2T - 1 unwindowed sums, which slide along the signal one
+         * sample at a time. Each frame then costs O(bins * (2T - 1) * hopLen)
+         * rather than O(bins * frame length), and this is used when it is less.
+         * A Kaiser window is not a sum of cosines, so its overlapping frames are
+         * each run from scratch.
+         *
+         * @param windowLen Length of single FFT (if larger than fftLen, sequence is zero padded)
+         * @param samplingFreq Sampling frequency (Hz)
+         * @param fftLen Length of FFT
+         * @param bins Indices of the windowLen point DFT bins to compute
+         * @param window Type of window. "hamm", "hann", "blackmanharris", "kaiser", "flattop" or "none".
+         * @param hopLen Number of samples between the start of consecutive frames. Defaults to fftLen.
+         */
+        GoertzelBank(int windowLen, int samplingFreq, int fftLen, const std::vector<int> &bins, std::string window="hamm", int hopLen=0);
+
+        ~GoertzelBank();
+
+        /**
+         * @brief Gets the indices of the count DFT bins closest to a frequency,
+         * e.g. to watch a band around a carrier
+         *
+         * @param freq Centre frequency (Hz)
+         * @param count Number of bins
+         * @param windowLen Length of single FFT
+         * @param samplingFreq Sampling frequency (Hz)
+         * @return std::vector<int>
+         */
+        static std::vector<int> binsAround(float freq, int count, int windowLen, int samplingFreq);
+
+        /**
+         * @brief Checks whether the bank does less work per frame than the
+         * windowLen point FFT of an STFT with the same parameters, so callers
+         * can pick whichever is cheaper for the bins they need
+         *
+         * @return true if the bank is cheaper
+         */
+        bool isCheaperThanFFT() const;
+
+        /**
+         * @brief Computes the chosen bins of every whole frame of fftLen samples,
+         * advancing by hopLen, as STFT::computeSTFT does for all bins. The result
+         * and time bins replace those of any previous call.
+         *
+         * @param signal
+         */
+        void computeSTFT(std::vector<std::complex<float>> *signal);
+
+        /**
+         * @brief Computes the chosen bins of every whole frame of a real signal
+         *
+         * @param signal
+         */
+        void computeSTFT(std::vector<float> *signal);
+
+        /**
+         * @brief Get the result, with frames as rows and the chosen bins as columns
+         *
+         * @return const Spectrogram<std::complex<float>>&
+         */
+        const Spectrogram<std::complex<float>> &getSpectrogram() const;
+
+        /**
+         * @brief Get the magnitude of the result
+         *
+         * @return Spectrogram<float>
+         */
+        Spectrogram<float> getMagSpectrogram() const;
+
+        /**
+         * @brief Get a copy of the magnitude result, returns a 2d float vector
+         *
+         * @return std::vector<std::vector<float>>
+         */
+        std::vector<std::vector<float>> getMagResult();
+
+        /**
+         * @brief Get the frequencies of the chosen bins
+         *
+         * @return std::vector<float>
+         */
+        std::vector<float> getFreqBins();
+
+        /**
+         * @brief Get the time bins of the last computation
+         *
+         * @return std::vector<float>
+         */
+        std::vector<float> getTimeBins();
+
+    private:
+        template <typename T>
+        void compute(const T *signal, int signalLen);
+
+        // flops per frame of each method
+        double fftCost() const;
+        double recomputeCost() const;
+        double slideCost() const;
+
+        // runs a Goertzel recursion over each frame
+        template <typename T>
+        void recompute(const T *signal, int signalLen, int numFrames);
+
+        // slides the unwindowed sums from frame to frame
+        template <typename T>
+        void slide(const T *signal, int numFrames);
+
+        int windowLen;
+        int samplingFreq;
+        int fftLen;
+        int hopLen;
+        std::vector<int> bins;
+
+        std::shared_ptr<const AlignedBuffer<float>> windowCoeffs;
+        // 2 cos(w) and e^-jw of each bin
+        std::vector<float> coeffs;
+        std::vector<std::complex<float>> rotations;
+        // e^-jw(fftLen - 1) of each bin, to move the result to the start of the frame
+        std::vector<std::complex<float>> phases;
+
+        // whether overlapping frames are slid rather than recomputed
+        bool sliding;
+        // 2T - 1 frequencies w + 2*pi*t/(fftLen + 1), t = -(T-1)..T-1, per bin,
+        // each with its window weight, e^jw and e^-jw(len - 1)
+        int terms;
+        std::vector<double> slideWeights;
+        std::vector<std::complex<double>> slideRotations;
+        std::vector<std::complex<double>> slideTails;
+
+        Spectrogram<std::complex<float>> result;
+        std::vector<float> freqBins;
+        std::vector<float> timeBins;
+};
+
+#endif // GOERTZELBANK_H
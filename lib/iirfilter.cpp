@@ -0,0 +1,178 @@
+#include <complex>
+#include <cmath>
+#include <algorithm>
+#include <stdexcept>
+#include "iirfilter.h"
+#include "simd.h"
+
+using namespace std;
+
+IirFilter::IirFilter(const std::vector<Biquad> &sections, int channels) :
+sections(sections), channels(channels) {
+    if (sections.empty() || channels <= 0) {
+        throw std::invalid_argument("IirFilter: needs at least one section and one channel");
+    } // if
+
+    for (int s = 0; s < sections.size(); s++) {
+        const Biquad &c = sections[s];
+        const float section[] = {c.b0, c.b1, c.b2, c.a1, c.a2};
+        IirFilter::coeffs.insert(IirFilter::coeffs.end(), section, section + 5);
+    } // for
+
+    IirFilter::state.resize(2 * sections.size() * channels);
+    IirFilter::reset();
+}
+
+IirFilter::~IirFilter() { }
+
+std::vector<Biquad> IirFilter::butterworthBandPass(int order, double fLow, double fHigh, int fs) {
+    return IirFilter::bandPass(order, 0, fLow, fHigh, fs);
+}
+
+std::vector<Biquad> IirFilter::chebyshevBandPass(int order, double ripple, double fLow, double fHigh, int fs) {
+    if (ripple <= 0) {
+        throw std::invalid_argument("IirFilter: the ripple must be positive");
+    } // if
+
+    return IirFilter::bandPass(order, ripple, fLow, fHigh, fs);
+}
+
+std::vector<Biquad> IirFilter::bandPass(int order, double ripple, double fLow, double fHigh, int fs) {
+    /**
+     * The analog lowpass prototype poles are moved to a band-pass about w0 with
+     * s -> (s^2 + w0^2) / (s bw), and mapped to z by the bilinear transform with
+     * prewarped cutoffs. Each prototype pole in the upper half plane gives two
+     * band-pass poles, and each of those a section with its conjugate and a
+     * zero at z = 1 and z = -1.
+     */
+    if (order <= 0 || fLow <= 0 || fHigh <= fLow || 2 * fHigh >= fs) {
+        throw std::invalid_argument("IirFilter: needs order > 0 and 0 < fLow < fHigh < fs/2");
+    } // if
+
+    double fs2 = 2.0 * fs;
+    double w1 = fs2 * tan(M_PI * fLow / fs);
+    double w2 = fs2 * tan(M_PI * fHigh / fs);
+    double w0 = sqrt(w1 * w2);
+    double bw = w2 - w1;
+
+    // prototype poles with a cutoff of 1 rad/s
+    std::vector<std::complex<double>> prototype;
+    double epsilon = sqrt(pow(10.0, ripple / 10.0) - 1);
+    double mu = ripple > 0 ? asinh(1 / epsilon) / order : 0;
+    for (int k = 0; k < order; k++) {
+        double theta = M_PI * (2 * k + 1) / (2.0 * order);
+        if (ripple > 0) {
+            prototype.push_back(std::complex<double>(-sinh(mu) * sin(theta), cosh(mu) * cos(theta)));
+        } else {
+            prototype.push_back(std::complex<double>(-sin(theta), cos(theta)));
+        } // else
+    } // for
+
+    // the centre of the band in z
+    std::complex<double> centre = std::polar(1.0, 2 * atan(w0 / fs2));
+
+    std::vector<Biquad> sections;
+    for (int k = 0; k < order; k++) {
+        std::complex<double> p = prototype[k];
+        if (p.imag() < -1e-12) {
+            // the conjugate of an upper half plane pole
+            continue;
+        } // if
+
+        std::complex<double> half = p * bw / 2.0;
+        std::complex<double> root = std::sqrt(half * half - w0 * w0);
+        std::complex<double> analog[2] = { half + root, half - root };
+
+        // a real prototype pole gives one pair, which may be two real poles
+        bool pair = std::abs(p.imag()) <= 1e-12;
+        int count = pair ? 1 : 2;
+
+        for (int i = 0; i < count; i++) {
+            std::complex<double> a = (fs2 + analog[i]) / (fs2 - analog[i]);
+            std::complex<double> b = pair ? (fs2 + analog[1]) / (fs2 - analog[1]) : std::conj(a);
+
+            Biquad q;
+            q.b0 = 1;
+            q.b1 = 0;
+            q.b2 = -1;
+            q.a1 = (float) -(a + b).real();
+            q.a2 = (float) (a * b).real();
+
+            // unit gain at the centre of the band
+            std::complex<double> zi = 1.0 / centre;
+            std::complex<double> num = 1.0 - zi * zi;
+            std::complex<double> den = 1.0 + (double) q.a1 * zi + (double) q.a2 * zi * zi;
+            float gain = (float) (1 / std::abs(num / den));
+            q.b0 *= gain;
+            q.b2 *= gain;
+
+            sections.push_back(q);
+        } // for
+    } // for
+
+    // an even order Chebyshev passband starts at a trough
+    if (ripple > 0 && order % 2 == 0) {
+        float scale = (float) (1 / sqrt(1 + epsilon * epsilon));
+        sections[0].b0 *= scale;
+        sections[0].b2 *= scale;
+    } // if
+
+    return sections;
+}
+
+void IirFilter::reset() {
+    std::fill(IirFilter::state.begin(), IirFilter::state.end(), 0.0f);
+}
+
+int IirFilter::getChannels() const {
+    return IirFilter::channels;
+}
+
+const std::vector<Biquad> &IirFilter::getSections() const {
+    return IirFilter::sections;
+}
+
+void IirFilter::process(const float *input, float *output, int count, int channel) {
+    if (channel < 0 || channel >= IirFilter::channels) {
+        throw std::invalid_argument("IirFilter: no such channel");
+    } // if
+
+    if (output != input) {
+        std::copy(input, input + count, output);
+    } // if
+
+    IirFilter::process(output, count, channel);
+}
+
+void IirFilter::process(float *samples, int count, int channel) {
+    if (channel < 0 || channel >= IirFilter::channels) {
+        throw std::invalid_argument("IirFilter: no such channel");
+    } // if
+
+    int sectionCount = IirFilter::sections.size();
+    float *state = &IirFilter::state[channel];
+
+    // a single channel is a recursion along time, which has nothing to run side by side
+    for (int n = 0; n < count; n++) {
+        float x = samples[n];
+
+        for (int s = 0; s < sectionCount; s++) {
+            const Biquad &c = IirFilter::sections[s];
+            float &s1 = state[2 * s * IirFilter::channels];
+            float &s2 = state[(2 * s + 1) * IirFilter::channels];
+
+            // transposed direct form II
+            float y = c.b0 * x + s1;
+            s1 = c.b1 * x + s2 - c.a1 * y;
+            s2 = c.b2 * x - c.a2 * y;
+            x = y;
+        } // for
+
+        samples[n] = x;
+    } // for
+}
+
+void IirFilter::processInterleaved(float *samples, int frames) {
+    Simd::biquadCascade(samples, frames, IirFilter::channels, &IirFilter::coeffs[0],
+        IirFilter::sections.size(), &IirFilter::state[0]);
+}
@@ -0,0 +1,125 @@
+#ifndef IIRFILTER_H
+#define IIRFILTER_H
+
+#include <vector>
+
+/**
+ * @brief Coefficients of a second-order section
+ * H(z) = (b0 + b1 z^-1 + b2 z^-2) / (1 + a1 z^-1 + a2 z^-2)
+ */
+struct Biquad {
+    float b0;
+    float b1;
+    float b2;
+    float a1;
+    float a2;
+};
+
+/**
+ * @brief An IIR filter run as a cascade of second-order sections (biquads) in
+ * transposed direct form II, over one or more independent channels. Each
+ * channel keeps its own state between calls, so streams can be filtered in
+ * blocks of any size. Interleaved channels are filtered side by side, one
+ * channel per vector lane.
+ */
+class IirFilter {
+    public:
+        /**
+         * @brief Construct a new IirFilter object
+         *
+         * @param sections Second-order sections, applied in order
+         * @param channels Number of independent channels
+         */
+        IirFilter(const std::vector<Biquad> &sections, int channels=1);
+
+        ~IirFilter();
+
+        /**
+         * @brief Designs a Butterworth band-pass filter, with unit gain at the
+         * centre of the band
+         *
+         * @param order Order of the lowpass prototype. The band-pass is of twice
+         * the order, and has order sections.
+         * @param fLow Low frequency cutoff (Hz)
+         * @param fHigh High frequency cutoff (Hz)
+         * @param fs Sampling frequency (Hz)
+         * @return std::vector<Biquad>
+         */
+        static std::vector<Biquad> butterworthBandPass(int order, double fLow, double fHigh, int fs);
+
+        /**
+         * @brief Designs a Chebyshev type I band-pass filter, with an equiripple
+         * passband between the cutoffs whose peak gain is 1
+         *
+         * @param order Order of the lowpass prototype. The band-pass is of twice
+         * the order, and has order sections.
+         * @param ripple Passband ripple (dB)
+         * @param fLow Low frequency cutoff (Hz)
+         * @param fHigh High frequency cutoff (Hz)
+         * @param fs Sampling frequency (Hz)
+         * @return std::vector<Biquad>
+         */
+        static std::vector<Biquad> chebyshevBandPass(int order, double ripple, double fLow, double fHigh, int fs);
+
+        /**
+         * @brief Filters a block of one channel, continuing from the previous block
+         *
+         * @param input Input samples
+         * @param output Output samples, which may be the same buffer as input
+         * @param count Number of samples
+         * @param channel Channel the samples belong to
+         */
+        void process(const float *input, float *output, int count, int channel=0);
+
+        /**
+         * @brief Filters a block of one channel in place, continuing from the previous block
+         *
+         * @param samples
+         * @param count Number of samples
+         * @param channel Channel the samples belong to
+         */
+        void process(float *samples, int count, int channel=0);
+
+        /**
+         * @brief Filters a block of all channels in place, interleaved as
+         * samples[frame * channels + channel]
+         *
+         * @param samples
+         * @param frames Number of samples per channel
+         */
+        void processInterleaved(float *samples, int frames);
+
+        /**
+         * @brief Clears the state of every channel
+         *
+         */
+        void reset();
+
+        /**
+         * @brief Gets the number of channels
+         *
+         * @return int
+         */
+        int getChannels() const;
+
+        /**
+         * @brief Gets the second-order sections
+         *
+         * @return const std::vector<Biquad>&
+         */
+        const std::vector<Biquad> &getSections() const;
+
+    private:
+        static std::vector<Biquad> bandPass(int order, double ripple, double fLow, double fHigh, int fs);
+
+        std::vector<Biquad> sections;
+        // b0, b1, b2, a1, a2 of each section, as read by Simd::biquadCascade
+        std::vector<float> coeffs;
+        int channels;
+
+        // two state values per section, each held for all channels
+        // side by side: state[(2 * section + k) * channels + channel]
+        std::vector<float> state;
+};
+
+#endif // IIRFILTER_H
@@ -0,0 +1,154 @@
+#include <complex>
+#include <cmath>
+#include <algorithm>
+#include <stdexcept>
+#include "peakfinder.h"
+
+using namespace std;
+
+namespace {
+
+float power(const std::complex<float> &x) {
+    return x.real() * x.real() + x.imag() * x.imag();
+}
+
+// tau(x) of Quinn's second estimator
+double quinnTau(double x) {
+    double root = sqrt(2.0 / 3.0);
+    return 0.25 * log(3 * x * x + 6 * x + 1)
+        - sqrt(6.0) / 24 * log((x + 1 - root) / (x + 1 + root));
+}
+
+} // namespace
+
+PeakFinder::PeakFinder(const std::vector<float> &freqBins, int peaks, Interpolation interpolation) :
+freqBins(freqBins), peaks(peaks), interpolation(interpolation) {
+    if (peaks <= 0) {
+        throw std::invalid_argument("PeakFinder: the number of peaks must be positive");
+    } // if
+}
+
+PeakFinder::~PeakFinder() { }
+
+void PeakFinder::find(const std::complex<float> *spectrum, int bins, std::vector<Peak> &peaks) const {
+    peaks.clear();
+    bins = std::min(bins, (int) PeakFinder::freqBins.size());
+    if (bins <= 0) {
+        return;
+    } // if
+
+    // a maximum rises above the bin before it and is not below the bin after
+    // it, so of equal bins the first is taken, as an argmax would
+    float before = -1;
+    float current = power(spectrum[0]);
+    for (int j = 0; j < bins; j++) {
+        float after = j + 1 < bins ? power(spectrum[j + 1]) : -1;
+
+        if (current > before && current >= after
+            && (peaks.size() < PeakFinder::peaks || current > peaks.back().power)) {
+            if (peaks.size() == PeakFinder::peaks) {
+                peaks.pop_back();
+            } // if
+
+            int pos = peaks.size();
+            while (pos > 0 && current > peaks[pos - 1].power) {
+                pos--;
+            } // while
+
+            Peak peak = {j, 0, 0, current};
+            peaks.insert(peaks.begin() + pos, peak);
+        } // if
+
+        before = current;
+        current = after;
+    } // for
+
+    for (int i = 0; i < peaks.size(); i++) {
+        Peak &peak = peaks[i];
+        peak.offset = PeakFinder::interpolate(spectrum, bins, peak.bin);
+        peak.freq = PeakFinder::freqBins[peak.bin];
+
+        if (peak.offset > 0) {
+            peak.freq += peak.offset * (PeakFinder::freqBins[peak.bin + 1] - PeakFinder::freqBins[peak.bin]);
+        } else if (peak.offset < 0) {
+            peak.freq += peak.offset * (PeakFinder::freqBins[peak.bin] - PeakFinder::freqBins[peak.bin - 1]);
+        } // else if
+    } // for
+}
+
+std::vector<std::vector<Peak>> PeakFinder::find(const Spectrogram<std::complex<float>> &spectrogram) const {
+    std::vector<std::vector<Peak>> res(spectrogram.getFrameCount());
+
+    for (int i = 0; i < spectrogram.getFrameCount(); i++) {
+        PeakFinder::find(spectrogram.row(i).data(), spectrogram.getBinCount(), res[i]);
+    } // for
+
+    return res;
+}
+
+std::vector<float> PeakFinder::getPrinciple(const Spectrogram<std::complex<float>> &spectrogram) const {
+    std::vector<float> res;
+    std::vector<Peak> frame;
+
+    for (int i = 0; i < spectrogram.getFrameCount(); i++) {
+        PeakFinder::find(spectrogram.row(i).data(), spectrogram.getBinCount(), frame);
+        res.push_back(frame.empty() ? 0 : frame[0].freq);
+    } // for
+
+    return res;
+}
+
+int PeakFinder::getPeakCount() const {
+    return PeakFinder::peaks;
+}
+
+PeakFinder::Interpolation PeakFinder::getInterpolation() const {
+    return PeakFinder::interpolation;
+}
+
+float PeakFinder::interpolate(const std::complex<float> *spectrum, int bins, int bin) const {
+    if (PeakFinder::interpolation == NONE || bin == 0 || bin == bins - 1) {
+        return 0;
+    } // if
+
+    double a = power(spectrum[bin - 1]);
+    double b = power(spectrum[bin]);
+    double c = power(spectrum[bin + 1]);
+    double offset = 0;
+
+    switch (PeakFinder::interpolation) {
+        case PARABOLIC: {
+            a = sqrt(a);
+            b = sqrt(b);
+            c = sqrt(c);
+            double denom = a - 2 * b + c;
+            offset = denom < 0 ? 0.5 * (a - c) / denom : 0;
+            break;
+        }
+        case GAUSSIAN: {
+            // the log of the power is twice that of the magnitude, which cancels
+            if (a > 0 && c > 0) {
+                double la = log(a);
+                double lb = log(b);
+                double lc = log(c);
+                double denom = la - 2 * lb + lc;
+                offset = denom < 0 ? 0.5 * (la - lc) / denom : 0;
+            } // if
+            break;
+        }
+        case QUINN: {
+            // Re(X[k+1]/X[k]) and Re(X[k-1]/X[k])
+            const std::complex<float> &x = spectrum[bin];
+            double ap = (spectrum[bin + 1].real() * x.real() + spectrum[bin + 1].imag() * x.imag()) / b;
+            double am = (spectrum[bin - 1].real() * x.real() + spectrum[bin - 1].imag() * x.imag()) / b;
+            double dp = -ap / (1 - ap);
+            double dm = am / (1 - am);
+            offset = (dp + dm) / 2 + quinnTau(dp * dp) - quinnTau(dm * dm);
+            break;
+        }
+        default:
+            break;
+    } // switch
+
+    return (float) std::max(-0.5, std::min(0.5, offset));
+}
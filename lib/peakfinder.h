@@ -0,0 +1,97 @@
+#ifndef PEAKFINDER_H
+#define PEAKFINDER_H
+
+#include <complex>
+#include <vector>
+#include "spectrogram.h"
+
+/**
+ * @brief A spectral peak, located between bins by interpolation
+ */
+struct Peak {
+    // bin of the local maximum
+    int bin;
+    // offset of the interpolated peak from bin, in [-0.5, 0.5] bins
+    float offset;
+    // frequency of the interpolated peak (Hz)
+    float freq;
+    // squared magnitude at bin
+    float power;
+};
+
+class PeakFinder {
+    public:
+        /**
+         * @brief Ways of estimating where a peak lies between bins. PARABOLIC
+         * and GAUSSIAN fit a parabola through the magnitude, or its log, of the
+         * peak bin and its neighbours; GAUSSIAN is exact for a Gaussian window and
+         * close for Hamming, Hann and Kaiser. QUINN uses the complex neighbours
+         * and is best suited to unwindowed ("none") spectra.
+         */
+        enum Interpolation {NONE, PARABOLIC, GAUSSIAN, QUINN};
+
+        /**
+         * @brief Construct a new PeakFinder object, which picks the largest local
+         * maxima of each frame of a complex spectrum. A frame is scanned once
+         * using |X|^2, so no magnitude spectrogram (and no sqrt per bin) is needed.
+         *
+         * @param freqBins Frequency of each bin (Hz), as given by STFT::getFreqBins
+         * @param peaks Number of peaks to return per frame
+         * @param interpolation Sub-bin interpolation of each peak
+         */
+        PeakFinder(const std::vector<float> &freqBins, int peaks=1, Interpolation interpolation=PARABOLIC);
+
+        ~PeakFinder();
+
+        /**
+         * @brief Finds the largest peaks of one frame, in order of decreasing
+         * power. Fewer than the requested number are returned if the frame has
+         * fewer local maxima.
+         *
+         * @param spectrum bins values of the frame
+         * @param bins Number of bins, at most the number of frequency bins
+         * @param peaks Replaced with the peaks found
+         */
+        void find(const std::complex<float> *spectrum, int bins, std::vector<Peak> &peaks) const;
+
+        /**
+         * @brief Finds the largest peaks of each frame of a spectrogram
+         *
+         * @param spectrogram
+         * @return std::vector<std::vector<Peak>> with one row per frame
+         */
+        std::vector<std::vector<Peak>> find(const Spectrogram<std::complex<float>> &spectrogram) const;
+
+        /**
+         * @brief Get the interpolated frequency of the largest peak of each frame,
+         * or 0 for a frame without one
+         *
+         * @param spectrogram
+         * @return std::vector<float>
+         */
+        std::vector<float> getPrinciple(const Spectrogram<std::complex<float>> &spectrogram) const;
+
+        /**
+         * @brief Gets the number of peaks returned per frame
+         *
+         * @return int
+         */
+        int getPeakCount() const;
+
+        /**
+         * @brief Gets the sub-bin interpolation
+         *
+         * @return Interpolation
+         */
+        Interpolation getInterpolation() const;
+
+    private:
+        // offset of the peak at bin, in [-0.5, 0.5] bins
+        float interpolate(const std::complex<float> *spectrum, int bins, int bin) const;
+
+        std::vector<float> freqBins;
+        int peaks;
+        Interpolation interpolation;
+};
+
+#endif // PEAKFINDER_H
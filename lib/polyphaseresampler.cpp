@@ -0,0 +1,161 @@
+#include <complex>
+#include <memory>
+#include <algorithm>
+#include <stdexcept>
+#include "polyphaseresampler.h"
+#include "filterdesigncache.h"
+
+using namespace std;
+
+namespace {
+
+int gcd(int a, int b) {
+    while (b != 0) {
+        int t = a % b;
+        a = b;
+        b = t;
+    } // while
+    return a;
+}
+
+} // namespace
+
+template <typename T>
+PolyphaseResampler<T>::PolyphaseResampler(int up, int down, int filterLen, double att) {
+    if (up <= 0 || down <= 0) {
+        throw std::invalid_argument("PolyphaseResampler: the factors must be positive");
+    } // if
+
+    int common = gcd(up, down);
+    int rate = std::max(up, down) / common;
+
+    // the designer is symmetric about the middle tap, so the length is odd
+    int len = filterLen > 0 ? filterLen : 16 * (up / common) + 1;
+    if (len < 2 * rate + 1) {
+        len = 2 * rate + 1;
+    } // if
+    if (len % 2 == 0) {
+        len++;
+    } // if
+
+    // the cutoff is relative to the upsampled rate, so design
+    // at a rate of 2 * rate for a cutoff of 1
+    std::shared_ptr<const std::vector<double>> design = FilterDesignCache::kaiserBessel(len, att, 1, 0, 2 * rate);
+    std::vector<float> coeffs(design->begin(), design->end());
+
+    // the filter is designed for the reduced ratio, so it runs at that rate
+    PolyphaseResampler::init(up / common, down / common, coeffs);
+}
+
+template <typename T>
+PolyphaseResampler<T>::PolyphaseResampler(int up, int down, const std::vector<float> &coeffs) {
+    if (up <= 0 || down <= 0) {
+        throw std::invalid_argument("PolyphaseResampler: the factors must be positive");
+    } // if
+
+    PolyphaseResampler::init(up, down, coeffs);
+}
+
+template <typename T>
+PolyphaseResampler<T>::~PolyphaseResampler() { }
+
+template <typename T>
+void PolyphaseResampler<T>::init(int up, int down, const std::vector<float> &coeffs) {
+    if (coeffs.empty()) {
+        throw std::invalid_argument("PolyphaseResampler: no coefficients");
+    } // if
+
+    // the given taps are at up times the input rate, so up is kept as it is
+    PolyphaseResampler::up = up;
+    PolyphaseResampler::down = down;
+
+    int len = coeffs.size();
+    int L = PolyphaseResampler::up;
+    PolyphaseResampler::branchLen = (len + L - 1) / L;
+
+    // the upsampled signal is zero stuffed, so each branch is
+    // scaled by up to keep the gain of the filter
+    int K = PolyphaseResampler::branchLen;
+    PolyphaseResampler::branches.assign(L * K, 0);
+    for (int p = 0; p < L; p++) {
+        for (int j = 0; j < K && p + j * L < len; j++) {
+            PolyphaseResampler::branches[p * K + K - 1 - j] = coeffs[p + j * L] * L;
+        } // for
+    } // for
+
+    PolyphaseResampler::work.resize(K - 1 + PolyphaseResampler::blockLen);
+    PolyphaseResampler::reset();
+}
+
+template <typename T>
+void PolyphaseResampler<T>::reset() {
+    std::fill(PolyphaseResampler::work.begin(), PolyphaseResampler::work.end(), T(0));
+    PolyphaseResampler::next = 0;
+}
+
+template <typename T>
+int PolyphaseResampler<T>::getUp() const {
+    return PolyphaseResampler::up;
+}
+
+template <typename T>
+int PolyphaseResampler<T>::getDown() const {
+    return PolyphaseResampler::down;
+}
+
+template <typename T>
+int PolyphaseResampler<T>::getMaxOutputCount(int count) const {
+    return (int) (((long long) count * PolyphaseResampler::up) / PolyphaseResampler::down) + 1;
+}
+
+template <typename T>
+int PolyphaseResampler<T>::process(const T *input, int count, T *output) {
+    int L = PolyphaseResampler::up;
+    int M = PolyphaseResampler::down;
+    int K = PolyphaseResampler::branchLen;
+    int block = PolyphaseResampler::blockLen;
+    int written = 0;
+
+    while (count > 0) {
+        int n = std::min(count, block);
+        std::copy(input, input + n, PolyphaseResampler::work.begin() + K - 1);
+
+        // output t of the upsampled rate falls on input t / L, and only
+        // branch t % L of the filter meets non-zero upsampled inputs
+        long long end = (long long) n * L;
+        for (; PolyphaseResampler::next < end; PolyphaseResampler::next += M) {
+            int i = (int) (PolyphaseResampler::next / L);
+            int p = (int) (PolyphaseResampler::next % L);
+
+            const T *x = &PolyphaseResampler::work[i];
+            const float *taps = &PolyphaseResampler::branches[p * K];
+
+            T sum = T(0);
+            for (int j = 0; j < K; j++) {
+                sum += x[j] * taps[j];
+            } // for
+            output[written++] = sum;
+        } // for
+        PolyphaseResampler::next -= end;
+
+        // the last K - 1 inputs are kept for the next block
+        std::copy(PolyphaseResampler::work.begin() + n, PolyphaseResampler::work.begin() + n + K - 1, PolyphaseResampler::work.begin());
+
+        input += n;
+        count -= n;
+    } // while
+
+    return written;
+}
+
+template <typename T>
+std::vector<T> PolyphaseResampler<T>::process(const std::vector<T> &input) {
+    std::vector<T> output(PolyphaseResampler::getMaxOutputCount(input.size()));
+    int written = input.empty() ? 0 : PolyphaseResampler::process(&input[0], input.size(), &output[0]);
+    output.resize(written);
+
+    return output;
+}
+
+template class PolyphaseResampler<float>;
+template class PolyphaseResampler<std::complex<float>>;
@@ -0,0 +1,116 @@
+#ifndef POLYPHASERESAMPLER_H
+#define POLYPHASERESAMPLER_H
+
+#include <complex>
+#include <vector>
+
+/**
+ * @brief Changes the sampling rate of a stream by a rational factor up/down,
+ * i.e. upsampling by up, lowpass filtering and downsampling by down, without
+ * ever computing the zero stuffed inputs or the discarded outputs. The
+ * lowpass filter is split into up polyphase branches of len/up taps, and each
+ * output runs a single branch over the input. With up = 1 this is a decimator
+ * and with down = 1 an interpolator. Like FirFilter, the last input samples are
+ * kept between calls, so a stream can be resampled in blocks of any size.
+ *
+ * @tparam T Sample type, float or std::complex<float>
+ */
+template <typename T>
+class PolyphaseResampler {
+    public:
+        /**
+         * @brief Construct a new PolyphaseResampler object with a Kaiser-Bessel lowpass
+         * filter, cut off at the lower of the two Nyquist frequencies. up and down
+         * are reduced by their common factors before the filter is designed.
+         *
+         * @param up Upsampling factor L
+         * @param down Downsampling factor M
+         * @param filterLen Length of the lowpass filter at the upsampled rate, or <= 0
+         * for 16 taps per branch
+         * @param att Attenuation (dB) in side lobes
+         */
+        PolyphaseResampler(int up, int down, int filterLen=0, double att=60);
+
+        /**
+         * @brief Construct a new PolyphaseResampler object with a given lowpass filter.
+         * up and down are used as given, as the filter is designed for up times
+         * the input rate.
+         *
+         * @param up Upsampling factor L
+         * @param down Downsampling factor M
+         * @param coeffs Lowpass filter coefficients at the upsampled rate, with unit gain
+         */
+        PolyphaseResampler(int up, int down, const std::vector<float> &coeffs);
+
+        ~PolyphaseResampler();
+
+        /**
+         * @brief Resamples a block of samples, continuing from the previous block
+         *
+         * @param input Input samples
+         * @param count Number of input samples
+         * @param output Output of at least getMaxOutputCount(count) samples
+         * @return int Number of output samples
+         */
+        int process(const T *input, int count, T *output);
+
+        /**
+         * @brief Resamples a block of samples, continuing from the previous block
+         *
+         * @param input Input samples
+         * @return std::vector<T> Output samples
+         */
+        std::vector<T> process(const std::vector<T> &input);
+
+        /**
+         * @brief Gets the largest number of outputs of a block of count inputs
+         *
+         * @param count Number of input samples
+         * @return int
+         */
+        int getMaxOutputCount(int count) const;
+
+        /**
+         * @brief Clears the stored input, as if the resampler had only seen zeros
+         *
+         */
+        void reset();
+
+        /**
+         * @brief Gets the upsampling factor the filter runs at, reduced for the
+         * Kaiser-Bessel design and as given with coefficients
+         *
+         * @return int
+         */
+        int getUp() const;
+
+        /**
+         * @brief Gets the downsampling factor the filter runs at, reduced for the
+         * Kaiser-Bessel design and as given with coefficients
+         *
+         * @return int
+         */
+        int getDown() const;
+
+    private:
+        void init(int up, int down, const std::vector<float> &coeffs);
+
+        // input samples resampled at a time
+        static const int blockLen = 1024;
+
+        int up;
+        int down;
+        // taps per branch
+        int branchLen;
+        // branch p holds coeffs[p + j*up] * up in reverse,
+        // to run forwards over the input
+        std::vector<float> branches;
+
+        // the last branchLen - 1 inputs followed by a block of input
+        std::vector<T> work;
+        // position of the next output at the upsampled rate,
+        // relative to the first input of the block
+        long long next;
+};
+
+#endif // POLYPHASERESAMPLER_H
@@ -0,0 +1,840 @@
+#include <atomic>
+#include <complex>
+#include <cstdint>
+#include <cstring>
+#include "simd.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SIMD_X86
+#include <immintrin.h>
+#endif
+
+using namespace std;
+
+namespace {
+
+typedef void (*ButterflyKernel)(std::complex<float> *, std::complex<float> *, const std::complex<float> *, int);
+typedef void (*Radix4Kernel)(std::complex<float> *, std::complex<float> *, std::complex<float> *, std::complex<float> *,
+    const std::complex<float> *, const std::complex<float> *, const std::complex<float> *, int);
+typedef void (*SplitRadixKernel)(std::complex<float> *, std::complex<float> *, std::complex<float> *, std::complex<float> *,
+    const std::complex<float> *, const std::complex<float> *, int);
+typedef void (*MultiplyKernel)(const std::complex<float> *, const std::complex<float> *, std::complex<float> *, int);
+typedef void (*SymmetricFirKernel)(const float *, const float *, int, int, float *, int);
+typedef void (*BiquadKernel)(float *, int, int, int, const float *, int, float *, int);
+typedef void (*ConvertKernel)(const unsigned char *, int, float *, int);
+
+/*
+ * Scalar kernels, also used for the tails of the vectorized kernels
+ */
+
+void butterflyScalar(std::complex<float> *lo, std::complex<float> *hi, const std::complex<float> *twid, int count) {
+    for (int i = 0; i < count; i++) {
+        float re = hi[i].real() * twid[i].real() - hi[i].imag() * twid[i].imag();
+        float im = hi[i].real() * twid[i].imag() + hi[i].imag() * twid[i].real();
+
+        hi[i] = std::complex<float>(lo[i].real() - re, lo[i].imag() - im);
+        lo[i] = std::complex<float>(lo[i].real() + re, lo[i].imag() + im);
+    } // for
+}
+
+inline std::complex<float> mulScalar(std::complex<float> a, std::complex<float> w) {
+    return std::complex<float>(a.real() * w.real() - a.imag() * w.imag(),
+                               a.real() * w.imag() + a.imag() * w.real());
+}
+
+void radix4Scalar(std::complex<float> *p0, std::complex<float> *p1, std::complex<float> *p2, std::complex<float> *p3,
+    const std::complex<float> *w1, const std::complex<float> *w2, const std::complex<float> *w3, int count) {
+    for (int i = 0; i < count; i++) {
+        std::complex<float> a = p0[i];
+        std::complex<float> b = mulScalar(p1[i], w2[i]);
+        std::complex<float> c = mulScalar(p2[i], w1[i]);
+        std::complex<float> d = mulScalar(p3[i], w3[i]);
+
+        std::complex<float> s0 = a + b;
+        std::complex<float> s1 = a - b;
+        std::complex<float> s2 = c + d;
+        // -j * (c - d)
+        std::complex<float> s3((c - d).imag(), -(c - d).real());
+
+        p0[i] = s0 + s2;
+        p1[i] = s1 + s3;
+        p2[i] = s0 - s2;
+        p3[i] = s1 - s3;
+    } // for
+}
+
+void splitRadixScalar(std::complex<float> *p0, std::complex<float> *p1, std::complex<float> *p2, std::complex<float> *p3,
+    const std::complex<float> *w1, const std::complex<float> *w3, int count) {
+    for (int i = 0; i < count; i++) {
+        std::complex<float> a = mulScalar(p2[i], w1[i]);
+        std::complex<float> b = mulScalar(p3[i], w3[i]);
+
+        std::complex<float> s = a + b;
+        // -j * (a - b)
+        std::complex<float> d((a - b).imag(), -(a - b).real());
+
+        p2[i] = p0[i] - s;
+        p0[i] = p0[i] + s;
+        p3[i] = p1[i] - d;
+        p1[i] = p1[i] + d;
+    } // for
+}
+
+void complexMultiplyScalar(const std::complex<float> *a, const std::complex<float> *b, std::complex<float> *out, int count) {
+    for (int i = 0; i < count; i++) {
+        float re = a[i].real() * b[i].real() - a[i].imag() * b[i].imag();
+        float im = a[i].real() * b[i].imag() + a[i].imag() * b[i].real();
+
+        out[i] = std::complex<float>(re, im);
+    } // for
+}
+
+// the FIR kernels run over interleaved floats, so a complex sample
+// is step = 2 floats apart and each output float is filtered separately
+void symmetricFirScalar(const float *input, const float *taps, int len, int step, float *output, int count) {
+    int half = len / 2;
+    const float *mirror = input + (len - 1) * step;
+
+    for (int j = 0; j < count; j++) {
+        float acc = 0;
+        for (int k = 0; k < half; k++) {
+            acc += taps[k] * (input[j + k * step] + mirror[j - k * step]);
+        } // for
+
+        if (len % 2) {
+            acc += taps[half] * input[j + half * step];
+        } // if
+
+        output[j] = acc;
+    } // for
+}
+
+// the biquad kernels filter lanes independent channels, interleaved in
+// samples[frame * stride + lane], each with the state of section s held in
+// state[2s * stateStride + lane] and state[(2s + 1) * stateStride + lane]
+void biquadScalar(float *samples, int frames, int stride, int lanes, const float *coeffs, int sections, float *state, int stateStride) {
+    for (int l = 0; l < lanes; l++) {
+        for (int f = 0; f < frames; f++) {
+            float x = samples[f * stride + l];
+
+            for (int s = 0; s < sections; s++) {
+                const float *c = coeffs + 5 * s;
+                float &s1 = state[2 * s * stateStride + l];
+                float &s2 = state[(2 * s + 1) * stateStride + l];
+
+                // transposed direct form II
+                float y = c[0] * x + s1;
+                s1 = c[1] * x + s2 - c[3] * y;
+                s2 = c[2] * x - c[4] * y;
+                x = y;
+            } // for
+
+            samples[f * stride + l] = x;
+        } // for
+    } // for
+}
+
+// the convert kernels read little endian samples step samples apart, from
+// input that need not be aligned; the vectorized ones take contiguous and
+// 2 channel interleaved samples, whose last register load reaches one sample
+// past the last sample it converts, so that sample is always left to the tail
+void int16Scalar(const unsigned char *input, int step, float *output, int count) {
+    const float scale = 1.0f / 32768;
+    for (int i = 0; i < count; i++) {
+        int16_t v;
+        memcpy(&v, input + 2 * (long long) step * i, 2);
+        output[i] = v * scale;
+    } // for
+}
+
+void float32Scalar(const unsigned char *input, int step, float *output, int count) {
+    if (step == 1) {
+        memcpy(output, input, 4 * (size_t) count);
+        return;
+    } // if
+
+    for (int i = 0; i < count; i++) {
+        memcpy(&output[i], input + 4 * (long long) step * i, 4);
+    } // for
+}
+
+#ifdef SIMD_X86
+
+/*
+ * SSE2 kernels, 2 interleaved complex values per register
+ */
+
+inline __m128 mulSse2(__m128 a, __m128 w) {
+    const __m128 negReal = _mm_castsi128_ps(_mm_set_epi32(0, (int) 0x80000000, 0, (int) 0x80000000));
+
+    __m128 wr = _mm_shuffle_ps(w, w, _MM_SHUFFLE(2, 2, 0, 0));
+    __m128 wi = _mm_shuffle_ps(w, w, _MM_SHUFFLE(3, 3, 1, 1));
+    __m128 as = _mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 3, 0, 1));
+
+    // [ar*wr - ai*wi, ai*wr + ar*wi]
+    return _mm_add_ps(_mm_mul_ps(a, wr), _mm_xor_ps(_mm_mul_ps(as, wi), negReal));
+}
+
+// -j * v
+inline __m128 mulNegJSse2(__m128 v) {
+    const __m128 negImag = _mm_castsi128_ps(_mm_set_epi32((int) 0x80000000, 0, (int) 0x80000000, 0));
+    return _mm_xor_ps(_mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1)), negImag);
+}
+
+void butterflySse2(std::complex<float> *lo, std::complex<float> *hi, const std::complex<float> *twid, int count) {
+    int i = 0;
+    for (; i + 2 <= count; i+=2) {
+        __m128 l = _mm_loadu_ps((float*) (lo + i));
+        __m128 t = mulSse2(_mm_loadu_ps((float*) (hi + i)), _mm_loadu_ps((const float*) (twid + i)));
+
+        _mm_storeu_ps((float*) (hi + i), _mm_sub_ps(l, t));
+        _mm_storeu_ps((float*) (lo + i), _mm_add_ps(l, t));
+    } // for
+
+    butterflyScalar(lo + i, hi + i, twid + i, count - i);
+}
+
+void radix4Sse2(std::complex<float> *p0, std::complex<float> *p1, std::complex<float> *p2, std::complex<float> *p3,
+    const std::complex<float> *w1, const std::complex<float> *w2, const std::complex<float> *w3, int count) {
+    int i = 0;
+    for (; i + 2 <= count; i+=2) {
+        __m128 a = _mm_loadu_ps((float*) (p0 + i));
+        __m128 b = mulSse2(_mm_loadu_ps((float*) (p1 + i)), _mm_loadu_ps((const float*) (w2 + i)));
+        __m128 c = mulSse2(_mm_loadu_ps((float*) (p2 + i)), _mm_loadu_ps((const float*) (w1 + i)));
+        __m128 d = mulSse2(_mm_loadu_ps((float*) (p3 + i)), _mm_loadu_ps((const float*) (w3 + i)));
+
+        __m128 s0 = _mm_add_ps(a, b);
+        __m128 s1 = _mm_sub_ps(a, b);
+        __m128 s2 = _mm_add_ps(c, d);
+        __m128 s3 = mulNegJSse2(_mm_sub_ps(c, d));
+
+        _mm_storeu_ps((float*) (p0 + i), _mm_add_ps(s0, s2));
+        _mm_storeu_ps((float*) (p1 + i), _mm_add_ps(s1, s3));
+        _mm_storeu_ps((float*) (p2 + i), _mm_sub_ps(s0, s2));
+        _mm_storeu_ps((float*) (p3 + i), _mm_sub_ps(s1, s3));
+    } // for
+
+    radix4Scalar(p0 + i, p1 + i, p2 + i, p3 + i, w1 + i, w2 + i, w3 + i, count - i);
+}
+
+void splitRadixSse2(std::complex<float> *p0, std::complex<float> *p1, std::complex<float> *p2, std::complex<float> *p3,
+    const std::complex<float> *w1, const std::complex<float> *w3, int count) {
+    int i = 0;
+    for (; i + 2 <= count; i+=2) {
+        __m128 a = mulSse2(_mm_loadu_ps((float*) (p2 + i)), _mm_loadu_ps((const float*) (w1 + i)));
+        __m128 b = mulSse2(_mm_loadu_ps((float*) (p3 + i)), _mm_loadu_ps((const float*) (w3 + i)));
+        __m128 u0 = _mm_loadu_ps((float*) (p0 + i));
+        __m128 u1 = _mm_loadu_ps((float*) (p1 + i));
+
+        __m128 sum = _mm_add_ps(a, b);
+        __m128 dif = mulNegJSse2(_mm_sub_ps(a, b));
+
+        _mm_storeu_ps((float*) (p0 + i), _mm_add_ps(u0, sum));
+        _mm_storeu_ps((float*) (p2 + i), _mm_sub_ps(u0, sum));
+        _mm_storeu_ps((float*) (p1 + i), _mm_add_ps(u1, dif));
+        _mm_storeu_ps((float*) (p3 + i), _mm_sub_ps(u1, dif));
+    } // for
+
+    splitRadixScalar(p0 + i, p1 + i, p2 + i, p3 + i, w1 + i, w3 + i, count - i);
+}
+
+void complexMultiplySse2(const std::complex<float> *a, const std::complex<float> *b, std::complex<float> *out, int count) {
+    int i = 0;
+    for (; i + 2 <= count; i+=2) {
+        __m128 r = mulSse2(_mm_loadu_ps((const float*) (a + i)), _mm_loadu_ps((const float*) (b + i)));
+        _mm_storeu_ps((float*) (out + i), r);
+    } // for
+
+    complexMultiplyScalar(a + i, b + i, out + i, count - i);
+}
+
+void symmetricFirSse2(const float *input, const float *taps, int len, int step, float *output, int count) {
+    int half = len / 2;
+    const float *mirror = input + (len - 1) * step;
+
+    // 4 output floats per register, each pair of taps folded into one multiply
+    int j = 0;
+    for (; j + 4 <= count; j+=4) {
+        __m128 acc = _mm_setzero_ps();
+        for (int k = 0; k < half; k++) {
+            __m128 x = _mm_add_ps(_mm_loadu_ps(input + j + k * step), _mm_loadu_ps(mirror + j - k * step));
+            acc = _mm_add_ps(acc, _mm_mul_ps(_mm_set1_ps(taps[k]), x));
+        } // for
+
+        if (len % 2) {
+            acc = _mm_add_ps(acc, _mm_mul_ps(_mm_set1_ps(taps[half]), _mm_loadu_ps(input + j + half * step)));
+        } // if
+
+        _mm_storeu_ps(output + j, acc);
+    } // for
+
+    symmetricFirScalar(input + j, taps, len, step, output + j, count - j);
+}
+
+void biquadSse2(float *samples, int frames, int stride, int lanes, const float *coeffs, int sections, float *state, int stateStride) {
+    // 4 channels per register, so the recursion
+    // runs along time while the channels run across lanes
+    int l = 0;
+    for (; l + 4 <= lanes; l+=4) {
+        for (int f = 0; f < frames; f++) {
+            __m128 x = _mm_loadu_ps(samples + f * stride + l);
+
+            for (int s = 0; s < sections; s++) {
+                const float *c = coeffs + 5 * s;
+                float *s1 = state + 2 * s * stateStride + l;
+                float *s2 = state + (2 * s + 1) * stateStride + l;
+
+                __m128 y = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(c[0]), x), _mm_loadu_ps(s1));
+                _mm_storeu_ps(s1, _mm_sub_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(c[1]), x), _mm_loadu_ps(s2)), _mm_mul_ps(_mm_set1_ps(c[3]), y)));
+                _mm_storeu_ps(s2, _mm_sub_ps(_mm_mul_ps(_mm_set1_ps(c[2]), x), _mm_mul_ps(_mm_set1_ps(c[4]), y)));
+                x = y;
+            } // for
+
+            _mm_storeu_ps(samples + f * stride + l, x);
+        } // for
+    } // for
+
+    biquadScalar(samples + l, frames, stride, lanes - l, coeffs, sections, state + l, stateStride);
+}
+
+void int16Sse2(const unsigned char *input, int step, float *output, int count) {
+    const __m128 scale = _mm_set1_ps(1.0f / 32768);
+
+    int i = 0;
+    if (step == 1) {
+        // 8 samples per load, each moved into the top of a 32 bit lane so the shift extends the sign
+        for (; i + 8 <= count; i+=8) {
+            __m128i v = _mm_loadu_si128((const __m128i*) (input + 2 * i));
+            __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16);
+            __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(v, v), 16);
+            _mm_storeu_ps(output + i, _mm_mul_ps(_mm_cvtepi32_ps(lo), scale));
+            _mm_storeu_ps(output + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(hi), scale));
+        } // for
+    } else if (step == 2) {
+        // 4 samples per load, each the bottom of a 32 bit lane
+        for (; i + 4 < count; i+=4) {
+            __m128i v = _mm_loadu_si128((const __m128i*) (input + 4 * i));
+            __m128i x = _mm_srai_epi32(_mm_slli_epi32(v, 16), 16);
+            _mm_storeu_ps(output + i, _mm_mul_ps(_mm_cvtepi32_ps(x), scale));
+        } // for
+    } // else if
+
+    int16Scalar(input + 2 * (long long) step * i, step, output + i, count - i);
+}
+
+void float32Sse2(const unsigned char *input, int step, float *output, int count) {
+    int i = 0;
+    if (step == 2) {
+        // the even floats of two loads
+        for (; i + 4 < count; i+=4) {
+            __m128 a = _mm_loadu_ps((const float*) (input + 8 * i));
+            __m128 b = _mm_loadu_ps((const float*) (input + 8 * i + 16));
+            _mm_storeu_ps(output + i, _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)));
+        } // for
+    } // if
+
+    float32Scalar(input + 4 * (long long) step * i, step, output + i, count - i);
+}
+
+/*
+ * AVX2 kernels, 4 interleaved complex values per register
+ */
+
+__attribute__((target("avx2,fma")))
+inline __m256 mulAvx2(__m256 a, __m256 w) {
+    __m256 wr = _mm256_moveldup_ps(w);
+    __m256 wi = _mm256_movehdup_ps(w);
+    __m256 as = _mm256_permute_ps(a, 0xB1);
+
+    // even lanes a*wr - as*wi, odd lanes a*wr + as*wi
+    return _mm256_fmaddsub_ps(a, wr, _mm256_mul_ps(as, wi));
+}
+
+__attribute__((target("avx2,fma")))
+inline __m256 mulNegJAvx2(__m256 v) {
+    const __m256 negImag = _mm256_castsi256_ps(_mm256_set1_epi64x((long long) 0x8000000000000000ULL));
+    return _mm256_xor_ps(_mm256_permute_ps(v, 0xB1), negImag);
+}
+
+__attribute__((target("avx2,fma")))
+void butterflyAvx2(std::complex<float> *lo, std::complex<float> *hi, const std::complex<float> *twid, int count) {
+    int i = 0;
+    for (; i + 4 <= count; i+=4) {
+        __m256 l = _mm256_loadu_ps((float*) (lo + i));
+        __m256 t = mulAvx2(_mm256_loadu_ps((float*) (hi + i)), _mm256_loadu_ps((const float*) (twid + i)));
+
+        _mm256_storeu_ps((float*) (hi + i), _mm256_sub_ps(l, t));
+        _mm256_storeu_ps((float*) (lo + i), _mm256_add_ps(l, t));
+    } // for
+
+    butterflyScalar(lo + i, hi + i, twid + i, count - i);
+}
+
+__attribute__((target("avx2,fma")))
+void radix4Avx2(std::complex<float> *p0, std::complex<float> *p1, std::complex<float> *p2, std::complex<float> *p3,
+    const std::complex<float> *w1, const std::complex<float> *w2, const std::complex<float> *w3, int count) {
+    int i = 0;
+    for (; i + 4 <= count; i+=4) {
+        __m256 a = _mm256_loadu_ps((float*) (p0 + i));
+        __m256 b = mulAvx2(_mm256_loadu_ps((float*) (p1 + i)), _mm256_loadu_ps((const float*) (w2 + i)));
+        __m256 c = mulAvx2(_mm256_loadu_ps((float*) (p2 + i)), _mm256_loadu_ps((const float*) (w1 + i)));
+        __m256 d = mulAvx2(_mm256_loadu_ps((float*) (p3 + i)), _mm256_loadu_ps((const float*) (w3 + i)));
+
+        __m256 s0 = _mm256_add_ps(a, b);
+        __m256 s1 = _mm256_sub_ps(a, b);
+        __m256 s2 = _mm256_add_ps(c, d);
+        __m256 s3 = mulNegJAvx2(_mm256_sub_ps(c, d));
+
+        _mm256_storeu_ps((float*) (p0 + i), _mm256_add_ps(s0, s2));
+        _mm256_storeu_ps((float*) (p1 + i), _mm256_add_ps(s1, s3));
+        _mm256_storeu_ps((float*) (p2 + i), _mm256_sub_ps(s0, s2));
+        _mm256_storeu_ps((float*) (p3 + i), _mm256_sub_ps(s1, s3));
+    } // for
+
+    radix4Scalar(p0 + i, p1 + i, p2 + i, p3 + i, w1 + i, w2 + i, w3 + i, count - i);
+}
+
+__attribute__((target("avx2,fma")))
+void splitRadixAvx2(std::complex<float> *p0, std::complex<float> *p1, std::complex<float> *p2, std::complex<float> *p3,
+    const std::complex<float> *w1, const std::complex<float> *w3, int count) {
+    int i = 0;
+    for (; i + 4 <= count; i+=4) {
+        __m256 a = mulAvx2(_mm256_loadu_ps((float*) (p2 + i)), _mm256_loadu_ps((const float*) (w1 + i)));
+        __m256 b = mulAvx2(_mm256_loadu_ps((float*) (p3 + i)), _mm256_loadu_ps((const float*) (w3 + i)));
+        __m256 u0 = _mm256_loadu_ps((float*) (p0 + i));
+        __m256 u1 = _mm256_loadu_ps((float*) (p1 + i));
+
+        __m256 sum = _mm256_add_ps(a, b);
+        __m256 dif = mulNegJAvx2(_mm256_sub_ps(a, b));
+
+        _mm256_storeu_ps((float*) (p0 + i), _mm256_add_ps(u0, sum));
+        _mm256_storeu_ps((float*) (p2 + i), _mm256_sub_ps(u0, sum));
+        _mm256_storeu_ps((float*) (p1 + i), _mm256_add_ps(u1, dif));
+        _mm256_storeu_ps((float*) (p3 + i), _mm256_sub_ps(u1, dif));
+    } // for
+
+    splitRadixScalar(p0 + i, p1 + i, p2 + i, p3 + i, w1 + i, w3 + i, count - i);
+}
+
+__attribute__((target("avx2,fma")))
+void complexMultiplyAvx2(const std::complex<float> *a, const std::complex<float> *b, std::complex<float> *out, int count) {
+    int i = 0;
+    for (; i + 4 <= count; i+=4) {
+        __m256 r = mulAvx2(_mm256_loadu_ps((const float*) (a + i)), _mm256_loadu_ps((const float*) (b + i)));
+        _mm256_storeu_ps((float*) (out + i), r);
+    } // for
+
+    complexMultiplyScalar(a + i, b + i, out + i, count - i);
+}
+
+__attribute__((target("avx2,fma")))
+void symmetricFirAvx2(const float *input, const float *taps, int len, int step, float *output, int count) {
+    int half = len / 2;
+    const float *mirror = input + (len - 1) * step;
+
+    // 8 output floats per register, each pair of taps folded into one multiply
+    int j = 0;
+    for (; j + 8 <= count; j+=8) {
+        __m256 acc = _mm256_setzero_ps();
+        for (int k = 0; k < half; k++) {
+            __m256 x = _mm256_add_ps(_mm256_loadu_ps(input + j + k * step), _mm256_loadu_ps(mirror + j - k * step));
+            acc = _mm256_fmadd_ps(_mm256_set1_ps(taps[k]), x, acc);
+        } // for
+
+        if (len % 2) {
+            acc = _mm256_fmadd_ps(_mm256_set1_ps(taps[half]), _mm256_loadu_ps(input + j + half * step), acc);
+        } // if
+
+        _mm256_storeu_ps(output + j, acc);
+    } // for
+
+    symmetricFirSse2(input + j, taps, len, step, output + j, count - j);
+}
+
+__attribute__((target("avx2,fma")))
+void biquadAvx2(float *samples, int frames, int stride, int lanes, const float *coeffs, int sections, float *state, int stateStride) {
+    // 8 channels per register, so the recursion
+    // runs along time while the channels run across lanes
+    int l = 0;
+    for (; l + 8 <= lanes; l+=8) {
+        for (int f = 0; f < frames; f++) {
+            __m256 x = _mm256_loadu_ps(samples + f * stride + l);
+
+            for (int s = 0; s < sections; s++) {
+                const float *c = coeffs + 5 * s;
+                float *s1 = state + 2 * s * stateStride + l;
+                float *s2 = state + (2 * s + 1) * stateStride + l;
+
+                __m256 y = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(c[0]), x), _mm256_loadu_ps(s1));
+                _mm256_storeu_ps(s1, _mm256_sub_ps(_mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(c[1]), x), _mm256_loadu_ps(s2)), _mm256_mul_ps(_mm256_set1_ps(c[3]), y)));
+                _mm256_storeu_ps(s2, _mm256_sub_ps(_mm256_mul_ps(_mm256_set1_ps(c[2]), x), _mm256_mul_ps(_mm256_set1_ps(c[4]), y)));
+                x = y;
+            } // for
+
+            _mm256_storeu_ps(samples + f * stride + l, x);
+        } // for
+    } // for
+
+    biquadSse2(samples + l, frames, stride, lanes - l, coeffs, sections, state + l, stateStride);
+}
+
+__attribute__((target("avx2,fma")))
+void int16Avx2(const unsigned char *input, int step, float *output, int count) {
+    const __m256 scale = _mm256_set1_ps(1.0f / 32768);
+
+    int i = 0;
+    if (step == 1) {
+        for (; i + 16 <= count; i+=16) {
+            __m256i lo = _mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i*) (input + 2 * i)));
+            __m256i hi = _mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i*) (input + 2 * i + 16)));
+            _mm256_storeu_ps(output + i, _mm256_mul_ps(_mm256_cvtepi32_ps(lo), scale));
+            _mm256_storeu_ps(output + i + 8, _mm256_mul_ps(_mm256_cvtepi32_ps(hi), scale));
+        } // for
+    } else if (step == 2) {
+        for (; i + 8 < count; i+=8) {
+            __m256i v = _mm256_loadu_si256((const __m256i*) (input + 4 * i));
+            __m256i x = _mm256_srai_epi32(_mm256_slli_epi32(v, 16), 16);
+            _mm256_storeu_ps(output + i, _mm256_mul_ps(_mm256_cvtepi32_ps(x), scale));
+        } // for
+    } // else if
+
+    int16Sse2(input + 2 * (long long) step * i, step, output + i, count - i);
+}
+
+__attribute__((target("avx2,fma")))
+void float32Avx2(const unsigned char *input, int step, float *output, int count) {
+    int i = 0;
+    if (step == 2) {
+        // the even floats of each half, then the 64 bit pairs back in order
+        for (; i + 8 < count; i+=8) {
+            __m256 a = _mm256_loadu_ps((const float*) (input + 8 * i));
+            __m256 b = _mm256_loadu_ps((const float*) (input + 8 * i + 32));
+            __m256 even = _mm256_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+            _mm256_storeu_ps(output + i, _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(even), _MM_SHUFFLE(3, 1, 2, 0))));
+        } // for
+    } // if
+
+    float32Sse2(input + 4 * (long long) step * i, step, output + i, count - i);
+}
+
+/*
+ * AVX-512 kernels, 8 interleaved complex values per register
+ */
+
+__attribute__((target("avx512f")))
+inline __m512 mulAvx512(__m512 a, __m512 w) {
+    __m512 wr = _mm512_moveldup_ps(w);
+    __m512 wi = _mm512_movehdup_ps(w);
+    __m512 as = _mm512_permute_ps(a, 0xB1);
+
+    return _mm512_fmaddsub_ps(a, wr, _mm512_mul_ps(as, wi));
+}
+
+__attribute__((target("avx512f")))
+inline __m512 mulNegJAvx512(__m512 v) {
+    const __m512i negImag = _mm512_set1_epi64((long long) 0x8000000000000000ULL);
+    return _mm512_castsi512_ps(_mm512_xor_si512(_mm512_castps_si512(_mm512_permute_ps(v, 0xB1)), negImag));
+}
+
+__attribute__((target("avx512f")))
+void butterflyAvx512(std::complex<float> *lo, std::complex<float> *hi, const std::complex<float> *twid, int count) {
+    int i = 0;
+    for (; i + 8 <= count; i+=8) {
+        __m512 l = _mm512_loadu_ps((float*) (lo + i));
+        __m512 t = mulAvx512(_mm512_loadu_ps((float*) (hi + i)), _mm512_loadu_ps((const float*) (twid + i)));
+
+        _mm512_storeu_ps((float*) (hi + i), _mm512_sub_ps(l, t));
+        _mm512_storeu_ps((float*) (lo + i), _mm512_add_ps(l, t));
+    } // for
+
+    butterflyAvx2(lo + i, hi + i, twid + i, count - i);
+}
+
+__attribute__((target("avx512f")))
+void radix4Avx512(std::complex<float> *p0, std::complex<float> *p1, std::complex<float> *p2, std::complex<float> *p3,
+    const std::complex<float> *w1, const std::complex<float> *w2, const std::complex<float> *w3, int count) {
+    int i = 0;
+    for (; i + 8 <= count; i+=8) {
+        __m512 a = _mm512_loadu_ps((float*) (p0 + i));
+        __m512 b = mulAvx512(_mm512_loadu_ps((float*) (p1 + i)), _mm512_loadu_ps((const float*) (w2 + i)));
+        __m512 c = mulAvx512(_mm512_loadu_ps((float*) (p2 + i)), _mm512_loadu_ps((const float*) (w1 + i)));
+        __m512 d = mulAvx512(_mm512_loadu_ps((float*) (p3 + i)), _mm512_loadu_ps((const float*) (w3 + i)));
+
+        __m512 s0 = _mm512_add_ps(a, b);
+        __m512 s1 = _mm512_sub_ps(a, b);
+        __m512 s2 = _mm512_add_ps(c, d);
+        __m512 s3 = mulNegJAvx512(_mm512_sub_ps(c, d));
+
+        _mm512_storeu_ps((float*) (p0 + i), _mm512_add_ps(s0, s2));
+        _mm512_storeu_ps((float*) (p1 + i), _mm512_add_ps(s1, s3));
+        _mm512_storeu_ps((float*) (p2 + i), _mm512_sub_ps(s0, s2));
+        _mm512_storeu_ps((float*) (p3 + i), _mm512_sub_ps(s1, s3));
+    } // for
+
+    radix4Avx2(p0 + i, p1 + i, p2 + i, p3 + i, w1 + i, w2 + i, w3 + i, count - i);
+}
+
+__attribute__((target("avx512f")))
+void splitRadixAvx512(std::complex<float> *p0, std::complex<float> *p1, std::complex<float> *p2, std::complex<float> *p3,
+    const std::complex<float> *w1, const std::complex<float> *w3, int count) {
+    int i = 0;
+    for (; i + 8 <= count; i+=8) {
+        __m512 a = mulAvx512(_mm512_loadu_ps((float*) (p2 + i)), _mm512_loadu_ps((const float*) (w1 + i)));
+        __m512 b = mulAvx512(_mm512_loadu_ps((float*) (p3 + i)), _mm512_loadu_ps((const float*) (w3 + i)));
+        __m512 u0 = _mm512_loadu_ps((float*) (p0 + i));
+        __m512 u1 = _mm512_loadu_ps((float*) (p1 + i));
+
+        __m512 sum = _mm512_add_ps(a, b);
+        __m512 dif = mulNegJAvx512(_mm512_sub_ps(a, b));
+
+        _mm512_storeu_ps((float*) (p0 + i), _mm512_add_ps(u0, sum));
+        _mm512_storeu_ps((float*) (p2 + i), _mm512_sub_ps(u0, sum));
+        _mm512_storeu_ps((float*) (p1 + i), _mm512_add_ps(u1, dif));
+        _mm512_storeu_ps((float*) (p3 + i), _mm512_sub_ps(u1, dif));
+    } // for
+
+    splitRadixAvx2(p0 + i, p1 + i, p2 + i, p3 + i, w1 + i, w3 + i, count - i);
+}
+
+__attribute__((target("avx512f")))
+void complexMultiplyAvx512(const std::complex<float> *a, const std::complex<float> *b, std::complex<float> *out, int count) {
+    int i = 0;
+    for (; i + 8 <= count; i+=8) {
+        __m512 r = mulAvx512(_mm512_loadu_ps((const float*) (a + i)), _mm512_loadu_ps((const float*) (b + i)));
+        _mm512_storeu_ps((float*) (out + i), r);
+    } // for
+
+    complexMultiplyAvx2(a + i, b + i, out + i, count - i);
+}
+
+__attribute__((target("avx512f")))
+void symmetricFirAvx512(const float *input, const float *taps, int len, int step, float *output, int count) {
+    int half = len / 2;
+    const float *mirror = input + (len - 1) * step;
+
+    // 16 output floats per register, each pair of taps folded into one multiply
+    int j = 0;
+    for (; j + 16 <= count; j+=16) {
+        __m512 acc = _mm512_setzero_ps();
+        for (int k = 0; k < half; k++) {
+            __m512 x = _mm512_add_ps(_mm512_loadu_ps(input + j + k * step), _mm512_loadu_ps(mirror + j - k * step));
+            acc = _mm512_fmadd_ps(_mm512_set1_ps(taps[k]), x, acc);
+        } // for
+
+        if (len % 2) {
+            acc = _mm512_fmadd_ps(_mm512_set1_ps(taps[half]), _mm512_loadu_ps(input + j + half * step), acc);
+        } // if
+
+        _mm512_storeu_ps(output + j, acc);
+    } // for
+
+    symmetricFirAvx2(input + j, taps, len, step, output + j, count - j);
+}
+
+__attribute__((target("avx512f")))
+void biquadAvx512(float *samples, int frames, int stride, int lanes, const float *coeffs, int sections, float *state, int stateStride) {
+    // 16 channels per register, so the recursion
+    // runs along time while the channels run across lanes
+    int l = 0;
+    for (; l + 16 <= lanes; l+=16) {
+        for (int f = 0; f < frames; f++) {
+            __m512 x = _mm512_loadu_ps(samples + f * stride + l);
+
+            for (int s = 0; s < sections; s++) {
+                const float *c = coeffs + 5 * s;
+                float *s1 = state + 2 * s * stateStride + l;
+                float *s2 = state + (2 * s + 1) * stateStride + l;
+
+                __m512 y = _mm512_add_ps(_mm512_mul_ps(_mm512_set1_ps(c[0]), x), _mm512_loadu_ps(s1));
+                _mm512_storeu_ps(s1, _mm512_sub_ps(_mm512_add_ps(_mm512_mul_ps(_mm512_set1_ps(c[1]), x), _mm512_loadu_ps(s2)), _mm512_mul_ps(_mm512_set1_ps(c[3]), y)));
+                _mm512_storeu_ps(s2, _mm512_sub_ps(_mm512_mul_ps(_mm512_set1_ps(c[2]), x), _mm512_mul_ps(_mm512_set1_ps(c[4]), y)));
+                x = y;
+            } // for
+
+            _mm512_storeu_ps(samples + f * stride + l, x);
+        } // for
+    } // for
+
+    biquadAvx2(samples + l, frames, stride, lanes - l, coeffs, sections, state + l, stateStride);
+}
+
+__attribute__((target("avx512f")))
+void int16Avx512(const unsigned char *input, int step, float *output, int count) {
+    const __m512 scale = _mm512_set1_ps(1.0f / 32768);
+
+    int i = 0;
+    if (step == 1) {
+        for (; i + 16 <= count; i+=16) {
+            __m512i v = _mm512_cvtepi16_epi32(_mm256_loadu_si256((const __m256i*) (input + 2 * i)));
+            _mm512_storeu_ps(output + i, _mm512_mul_ps(_mm512_cvtepi32_ps(v), scale));
+        } // for
+    } else if (step == 2) {
+        for (; i + 16 < count; i+=16) {
+            __m512i v = _mm512_loadu_si512((const void*) (input + 4 * i));
+            __m512i x = _mm512_srai_epi32(_mm512_slli_epi32(v, 16), 16);
+            _mm512_storeu_ps(output + i, _mm512_mul_ps(_mm512_cvtepi32_ps(x), scale));
+        } // for
+    } // else if
+
+    int16Avx2(input + 2 * (long long) step * i, step, output + i, count - i);
+}
+
+__attribute__((target("avx512f")))
+void float32Avx512(const unsigned char *input, int step, float *output, int count) {
+    int i = 0;
+    if (step == 2) {
+        const __m512i even = _mm512_setr_epi32(0, 2, 4, 6, 8, 10, 12, 14, 16, 18, 20, 22, 24, 26, 28, 30);
+        for (; i + 16 < count; i+=16) {
+            __m512 a = _mm512_loadu_ps((const float*) (input + 8 * i));
+            __m512 b = _mm512_loadu_ps((const float*) (input + 8 * i + 64));
+            _mm512_storeu_ps(output + i, _mm512_permutex2var_ps(a, even, b));
+        } // for
+    } // if
+
+    float32Avx2(input + 4 * (long long) step * i, step, output + i, count - i);
+}
+
+#endif // SIMD_X86
+
+struct Dispatch {
+    Simd::Level level;
+    ButterflyKernel butterfly;
+    Radix4Kernel radix4;
+    SplitRadixKernel splitRadix;
+    MultiplyKernel complexMultiply;
+    SymmetricFirKernel symmetricFir;
+    BiquadKernel biquad;
+    ConvertKernel int16;
+    ConvertKernel float32;
+};
+
+Dispatch select(Simd::Level level) {
+    Dispatch d;
+    d.level = Simd::SCALAR;
+    d.butterfly = butterflyScalar;
+    d.radix4 = radix4Scalar;
+    d.splitRadix = splitRadixScalar;
+    d.complexMultiply = complexMultiplyScalar;
+    d.symmetricFir = symmetricFirScalar;
+    d.biquad = biquadScalar;
+    d.int16 = int16Scalar;
+    d.float32 = float32Scalar;
+
+#ifdef SIMD_X86
+    if (level >= Simd::SSE2) {
+        d.level = Simd::SSE2;
+        d.butterfly = butterflySse2;
+        d.radix4 = radix4Sse2;
+        d.splitRadix = splitRadixSse2;
+        d.complexMultiply = complexMultiplySse2;
+        d.symmetricFir = symmetricFirSse2;
+        d.biquad = biquadSse2;
+        d.int16 = int16Sse2;
+        d.float32 = float32Sse2;
+    } // if
+    if (level >= Simd::AVX2) {
+        d.level = Simd::AVX2;
+        d.butterfly = butterflyAvx2;
+        d.radix4 = radix4Avx2;
+        d.splitRadix = splitRadixAvx2;
+        d.complexMultiply = complexMultiplyAvx2;
+        d.symmetricFir = symmetricFirAvx2;
+        d.biquad = biquadAvx2;
+        d.int16 = int16Avx2;
+        d.float32 = float32Avx2;
+    } // if
+    if (level >= Simd::AVX512) {
+        d.level = Simd::AVX512;
+        d.butterfly = butterflyAvx512;
+        d.radix4 = radix4Avx512;
+        d.splitRadix = splitRadixAvx512;
+        d.complexMultiply = complexMultiplyAvx512;
+        d.symmetricFir = symmetricFirAvx512;
+        d.biquad = biquadAvx512;
+        d.int16 = int16Avx512;
+        d.float32 = float32Avx512;
+    } // if
+#endif
+
+    return d;
+}
+
+// the level kernels are dispatched to, initialised once, on first use
+std::atomic<int> &current() {
+    static std::atomic<int> level(Simd::detectLevel());
+    return level;
+}
+
+const Dispatch &dispatch() {
+    // one read-only table per level, so setLevel only swaps the index and
+    // kernels may be dispatched from other threads while it runs
+    static const Dispatch tables[] = {select(Simd::SCALAR), select(Simd::SSE2), select(Simd::AVX2), select(Simd::AVX512)};
+
+    return tables[current().load(std::memory_order_relaxed)];
+}
+
+} // namespace
+
+Simd::Level Simd::detectLevel() {
+#ifdef SIMD_X86
+    __builtin_cpu_init();
+
+    // the builtins also check the OS saves the wider registers, and the
+    // AVX-512 kernels hand their tails to the AVX2 ones, so need FMA too
+    if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+        return Simd::AVX512;
+    } else if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+        return Simd::AVX2;
+    } else if (__builtin_cpu_supports("sse2")) {
+        return Simd::SSE2;
+    } // else
+#endif
+    return Simd::SCALAR;
+}
+
+Simd::Level Simd::getLevel() {
+    return dispatch().level;
+}
+
+void Simd::setLevel(Simd::Level level) {
+    Simd::Level detected = Simd::detectLevel();
+    current().store(level > detected ? detected : level, std::memory_order_relaxed);
+}
+
+void Simd::butterfly(std::complex<float> *lo, std::complex<float> *hi, const std::complex<float> *twid, int count) {
+    dispatch().butterfly(lo, hi, twid, count);
+}
+
+void Simd::radix4Butterfly(std::complex<float> *p0, std::complex<float> *p1, std::complex<float> *p2, std::complex<float> *p3,
+    const std::complex<float> *w1, const std::complex<float> *w2, const std::complex<float> *w3, int count) {
+    dispatch().radix4(p0, p1, p2, p3, w1, w2, w3, count);
+}
+
+void Simd::splitRadixButterfly(std::complex<float> *p0, std::complex<float> *p1, std::complex<float> *p2, std::complex<float> *p3,
+    const std::complex<float> *w1, const std::complex<float> *w3, int count) {
+    dispatch().splitRadix(p0, p1, p2, p3, w1, w3, count);
+}
+
+void Simd::complexMultiply(const std::complex<float> *a, const std::complex<float> *b, std::complex<float> *out, int count) {
+    dispatch().complexMultiply(a, b, out, count);
+}
+
+void Simd::symmetricFir(const float *input, const float *taps, int len, float *output, int count) {
+    dispatch().symmetricFir(input, taps, len, 1, output, count);
+}
+
+void Simd::symmetricFir(const std::complex<float> *input, const float *taps, int len, std::complex<float> *output, int count) {
+    dispatch().symmetricFir((const float*) input, taps, len, 2, (float*) output, 2 * count);
+}
+
+void Simd::biquadCascade(float *samples, int frames, int channels, const float *coeffs, int sections, float *state) {
+    dispatch().biquad(samples, frames, channels, channels, coeffs, sections, state, channels);
+}
+
+void Simd::convertInt16(const void *input, int step, float *output, int count) {
+    dispatch().int16((const unsigned char*) input, step, output, count);
+}
+
+void Simd::convertFloat32(const void *input, int step, float *output, int count) {
+    dispatch().float32((const unsigned char*) input, step, output, count);
+}
@@ -0,0 +1,163 @@
+#ifndef SIMD_H
+#define SIMD_H
+
+#include <complex>
+
+class Simd {
+    public:
+        /**
+         * @brief Instruction sets with vectorized kernels, in increasing order
+         * of width. SSE2 processes 2 interleaved complex values per register,
+         * AVX2 4 and AVX-512 8.
+         */
+        enum Level { SCALAR = 0, SSE2 = 1, AVX2 = 2, AVX512 = 3 };
+
+        /**
+         * @brief Queries CPUID for the widest instruction set supported
+         * by both the processor and the operating system
+         *
+         * @return Level
+         */
+        static Level detectLevel();
+
+        /**
+         * @brief Get the instruction set the kernels are currently dispatched to.
+         * Defaults to detectLevel() on first use.
+         *
+         * @return Level
+         */
+        static Level getLevel();
+
+        /**
+         * @brief Force the kernels onto a given instruction set, e.g. SCALAR to
+         * check the vectorized results. Levels above detectLevel() are clamped.
+         * Safe to call while other threads run kernels; each call they make
+         * uses either the old or the new level throughout.
+         *
+         * @param level
+         */
+        static void setLevel(Level level);
+
+        /**
+         * @brief Computes count radix-2 butterflies, where the twiddled lower half
+         * hi[i] * twid[i] is added to and subtracted from the upper half lo[i] in place
+         *
+         * @param lo First half of the butterfly
+         * @param hi Second half of the butterfly
+         * @param twid Contiguous twiddle factors, one per butterfly
+         * @param count Number of butterflies
+         */
+        static void butterfly(std::complex<float> *lo, std::complex<float> *hi, const std::complex<float> *twid, int count);
+
+        /**
+         * @brief Computes count radix-4 butterflies in place on the four quarters
+         * p0..p3 of a block, whose inputs are the DFTs of the x[4m], x[4m+2],
+         * x[4m+1] and x[4m+3] subsequences (i.e. radix-2 bit-reversed order)
+         *
+         * @param p0 First quarter of the block
+         * @param p1 Second quarter of the block
+         * @param p2 Third quarter of the block
+         * @param p3 Fourth quarter of the block
+         * @param w1 Twiddles W_n^k applied to p2
+         * @param w2 Twiddles W_n^2k applied to p1
+         * @param w3 Twiddles W_n^3k applied to p3
+         * @param count Number of butterflies (n/4)
+         */
+        static void radix4Butterfly(std::complex<float> *p0, std::complex<float> *p1, std::complex<float> *p2, std::complex<float> *p3,
+            const std::complex<float> *w1, const std::complex<float> *w2, const std::complex<float> *w3, int count);
+
+        /**
+         * @brief Computes count split-radix (L-shaped) butterflies in place, which
+         * combine the n/2 point DFT held in p0 and p1 with the two n/4 point DFTs
+         * held in p2 and p3
+         *
+         * @param p0 First quarter of the block
+         * @param p1 Second quarter of the block
+         * @param p2 Third quarter of the block
+         * @param p3 Fourth quarter of the block
+         * @param w1 Twiddles W_n^k applied to p2
+         * @param w3 Twiddles W_n^3k applied to p3
+         * @param count Number of butterflies (n/4)
+         */
+        static void splitRadixButterfly(std::complex<float> *p0, std::complex<float> *p1, std::complex<float> *p2, std::complex<float> *p3,
+            const std::complex<float> *w1, const std::complex<float> *w3, int count);
+
+        /**
+         * @brief Computes the element-wise complex multiplication out[i] = a[i] * b[i].
+         * out may alias either input.
+         *
+         * @param a First sequence
+         * @param b Second sequence
+         * @param out Output sequence
+         * @param count Number of values
+         */
+        static void complexMultiply(const std::complex<float> *a, const std::complex<float> *b, std::complex<float> *out, int count);
+
+        /**
+         * @brief Computes count outputs of a FIR filter with symmetric (linear phase)
+         * taps, output[n] = sum_k taps[k] * input[n + k]. Taps k and len - 1 - k are
+         * equal, so their inputs are added first and each pair costs one multiply,
+         * and consecutive outputs are computed together in each register.
+         *
+         * @param input Input of count + len - 1 samples, oldest first
+         * @param taps First (len + 1) / 2 taps
+         * @param len Number of taps
+         * @param output Output of count samples, which must not overlap input
+         * @param count Number of outputs
+         */
+        static void symmetricFir(const float *input, const float *taps, int len, float *output, int count);
+
+        /**
+         * @brief Computes count outputs of a FIR filter with symmetric (linear phase)
+         * real taps over complex samples, as symmetricFir of a real input but with
+         * the real and imaginary parts filtered side by side in each register.
+         *
+         * @param input Input of count + len - 1 samples, oldest first
+         * @param taps First (len + 1) / 2 taps
+         * @param len Number of taps
+         * @param output Output of count samples, which must not overlap input
+         * @param count Number of outputs
+         */
+        static void symmetricFir(const std::complex<float> *input, const float *taps, int len, std::complex<float> *output, int count);
+
+        /**
+         * @brief Filters interleaved channels in place through a cascade of
+         * second-order sections in transposed direct form II. The recursion
+         * runs along time, so the channels are filtered side by side, one per
+         * vector lane.
+         *
+         * @param samples Samples, interleaved as samples[frame * channels + channel]
+         * @param frames Number of samples per channel
+         * @param channels Number of channels
+         * @param coeffs b0, b1, b2, a1, a2 of each section
+         * @param sections Number of sections
+         * @param state Two values per section and channel, as
+         * state[(2 * section + k) * channels + channel]
+         */
+        static void biquadCascade(float *samples, int frames, int channels, const float *coeffs, int sections, float *state);
+
+        /**
+         * @brief Converts little endian 16 bit PCM samples to floats in [-1, 1).
+         * Contiguous samples (step 1) and one channel of two interleaved ones
+         * (step 2) are converted a register at a time, other steps one by one.
+         * No byte past the last sample is read.
+         *
+         * @param input First sample, which need not be aligned
+         * @param step Number of samples from one converted sample to the next
+         * @param output count values
+         * @param count Number of samples
+         */
+        static void convertInt16(const void *input, int step, float *output, int count);
+
+        /**
+         * @brief Copies little endian 32 bit float samples, as convertInt16
+         *
+         * @param input First sample, which need not be aligned
+         * @param step Number of samples from one copied sample to the next
+         * @param output count values
+         * @param count Number of samples
+         */
+        static void convertFloat32(const void *input, int step, float *output, int count);
+};
+
+#endif // SIMD_H
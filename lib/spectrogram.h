@@ -0,0 +1,146 @@
+#ifndef SPECTROGRAM_H
+#define SPECTROGRAM_H
+
+#include <cstddef>
+#include "alignedbuffer.h"
+
+/**
+ * @brief A non-owning view of count values spaced stride values apart, e.g. a
+ * row (stride 1) or a column (stride of the rows) of a spectrogram. The view
+ * is only valid while the values it points at are.
+ *
+ * @tparam T Value type, const for a read-only view
+ */
+template <typename T>
+class StridedSpan {
+    public:
+        StridedSpan() : values(0), count(0), step(1) {}
+
+        /**
+         * @brief Construct a new StridedSpan object
+         *
+         * @param values First value
+         * @param count Number of values
+         * @param stride Distance between consecutive values
+         */
+        StridedSpan(T *values, int count, int stride=1) : values(values), count(count), step(stride) {}
+
+        int size() const { return StridedSpan::count; }
+        int stride() const { return StridedSpan::step; }
+        T *data() const { return StridedSpan::values; }
+
+        T &operator[](int i) const { return StridedSpan::values[(ptrdiff_t) i * StridedSpan::step]; }
+
+    private:
+        T *values;
+        int count;
+        int step;
+};
+
+/**
+ * @brief A frames x bins spectrogram held row-major in one aligned allocation.
+ * Each frame (row) starts on its own alignment boundary, so rows are spaced
+ * getFrameStride() values apart, and the padding between them is unused.
+ * Rows and columns are handed out as views, without copying.
+ *
+ * @tparam T Value type, e.g. std::complex<float> or float for magnitudes
+ */
+template <typename T>
+class Spectrogram {
+    public:
+        Spectrogram() : frames(0), bins(0), frameStride(0) {}
+
+        /**
+         * @brief Construct a new Spectrogram object of uninitialised values
+         *
+         * @param frames Number of frames (time bins)
+         * @param bins Number of frequency bins per frame
+         * @param stride Least distance between frames, at least bins. Rounded up
+         * to the alignment, and defaults to bins.
+         */
+        Spectrogram(int frames, int bins, int stride=0) : frames(0), bins(0), frameStride(0) {
+            Spectrogram::resize(frames, bins, stride);
+        }
+
+        /**
+         * @brief Resizes the spectrogram. The values are left uninitialised.
+         *
+         * @param frames Number of frames (time bins)
+         * @param bins Number of frequency bins per frame
+         * @param stride Least distance between frames, at least bins. Rounded up
+         * to the alignment, and defaults to bins.
+         */
+        void resize(int frames, int bins, int stride=0) {
+            int perLine = AlignedBuffer<T>::alignment / sizeof(T);
+            if (perLine < 1) {
+                perLine = 1;
+            } // if
+
+            stride = stride > bins ? stride : bins;
+            stride = (stride + perLine - 1) / perLine * perLine;
+
+            Spectrogram::frames = frames;
+            Spectrogram::bins = bins;
+            Spectrogram::frameStride = stride;
+            Spectrogram::buffer.resize((size_t) frames * stride);
+        }
+
+        int getFrameCount() const { return Spectrogram::frames; }
+        int getBinCount() const { return Spectrogram::bins; }
+
+        /**
+         * @brief Gets the distance in values between the start of consecutive frames
+         *
+         * @return int
+         */
+        int getFrameStride() const { return Spectrogram::frameStride; }
+
+        bool empty() const { return Spectrogram::frames == 0; }
+
+        T *data() { return Spectrogram::buffer.data(); }
+        const T *data() const { return Spectrogram::buffer.data(); }
+
+        T &operator()(int frame, int bin) {
+            return Spectrogram::buffer[(size_t) frame * Spectrogram::frameStride + bin];
+        }
+
+        const T &operator()(int frame, int bin) const {
+            return Spectrogram::buffer[(size_t) frame * Spectrogram::frameStride + bin];
+        }
+
+        /**
+         * @brief Gets the spectrum of one frame
+         *
+         * @param frame
+         * @return StridedSpan<T>
+         */
+        StridedSpan<T> row(int frame) {
+            return StridedSpan<T>(&(*this)(frame, 0), Spectrogram::bins);
+        }
+
+        StridedSpan<const T> row(int frame) const {
+            return StridedSpan<const T>(&(*this)(frame, 0), Spectrogram::bins);
+        }
+
+        /**
+         * @brief Gets one frequency bin over all frames
+         *
+         * @param bin
+         * @return StridedSpan<T>
+         */
+        StridedSpan<T> column(int bin) {
+            return StridedSpan<T>(Spectrogram::buffer.data() + bin, Spectrogram::frames, Spectrogram::frameStride);
+        }
+
+        StridedSpan<const T> column(int bin) const {
+            return StridedSpan<const T>(Spectrogram::buffer.data() + bin, Spectrogram::frames, Spectrogram::frameStride);
+        }
+
+    private:
+        int frames;
+        int bins;
+        int frameStride;
+        AlignedBuffer<T> buffer;
+};
+
+#endif // SPECTROGRAM_H
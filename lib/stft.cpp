@@ -1,27 +1,40 @@
 #include <iostream>
 #include <complex>
 #include <string>
+#include <algorithm>
+#include <functional>
+#include <memory>
 #include "fft.h"
 #include "stft.h"
 #include "filter.h"
+#include "frameiterator.h"
+#include "threadpool.h"
+#include "windowcache.h"
 
 using namespace std;
 
-STFT::STFT(int windowLen, int samplingFreq, int fftLen, bool ignoreNquist, std::string window) :
+STFT::STFT(int windowLen, int samplingFreq, int fftLen, bool ignoreNquist, std::string window, int hopLen) :
 windowLen(windowLen),samplingFreq(samplingFreq),fftLen(fftLen),ignoreNquist(ignoreNquist),window(window) {
     FFT::setFFTLen(fftLen);
+    STFT::setHopLen(hopLen);
 
+    WindowCache::Type type = WindowCache::parseType(window);
+    if (type != WindowCache::RECTANGULAR) {
+        STFT::windowCoeffs = WindowCache::get(type, fftLen+1, WindowCache::defaultKaiserBeta);
+    } // if
+
+    STFT::zeroPadding = false;
     if (windowLen > fftLen) {
         STFT::zeroPadding = true;
     } // if
 
     if (ignoreNquist) {
         for (int i = 0; i < windowLen; i++) {
-            STFT::freqBins.push_back(i*(samplingFreq/windowLen));
+            STFT::freqBins.push_back(i*((float)samplingFreq/windowLen));
         } // for
     } else {
         for (int i = 0; i < windowLen/2; i++) {
-            STFT::freqBins.push_back(i*(samplingFreq/windowLen));
+            STFT::freqBins.push_back(i*((float)samplingFreq/windowLen));
         } // for
     } // else
 }
@@ -36,58 +49,159 @@ void STFT::fitSignal(std::vector<std::complex<float>> *signal) {
     }
 }
 
-void STFT::computeSTFT(std::vector<std::complex<float>> *signal) {
-    // the assumption is made here that the
-    // signal has been cleaned and padded
-    // i.e. length of input % windowLen == 0
+void STFT::fitSignal(std::vector<float> *signal) {
+    int lastIndex = (*signal).size() - (((*signal).size() / STFT::fftLen) * STFT::fftLen);
 
-    // calculate the time bins
-    for (int i = 0; i < (*signal).size(); i+=fftLen) {
-        STFT::timeBins.push_back(((float) i)/(STFT::samplingFreq));
+    for (int i = 0; i < lastIndex; i++) {
+        (*signal).pop_back();
     }
+}
+
+void STFT::setHopLen(int hopLen) {
+    // by default frames do not overlap
+    STFT::hopLen = hopLen > 0 ? hopLen : STFT::fftLen;
+}
 
-    // compute twiddles for all FFTs
-    FFT::computeTwiddles();
+int STFT::getHopLen() {
+    return STFT::hopLen;
+}
 
-    int len = FFT::getFFTLen();    
+void STFT::computeSTFT(std::vector<std::complex<float>> *signal) {
+    // the plan holds the twiddles for all FFTs
+    const FFTPlan &plan = FFT::getPlan(STFT::windowLen);
 
-    for (int n = 0; n < (*signal).size(); n+=len) {
-        vector<std::complex<float>> subSignal((*signal).begin() + n, (*signal).begin() + n + len);      
+    int len = FFT::getFFTLen();
+    int bins = ignoreNquist ? windowLen : windowLen/2;
 
-        // add zero padded tokens
-        if (STFT::zeroPadding) {
-            for (int i = 0; i < (windowLen - len); i++) {
-                subSignal.push_back(0);
-            } // for
-        } // if
+    const float *window = STFT::windowCoeffs ? STFT::windowCoeffs->data() : 0;
 
-        // add the window function
-        if (STFT::window == "hamm") {
-            vector<std::complex<float>> window = Filter::complexHammingWindow(len+1);
+    // frames are windowed and zero padded straight from the signal,
+    // and an empty signal gives no frames
+    FrameIterator<std::complex<float>> frameIt(signal->data(), signal->size(), len, STFT::hopLen,
+        window, windowLen);
+    int numFrames = frameIt.getFrameCount();
 
-            for (int i = 0; i < len; i++) {
-                subSignal[i] *= window[i];
-            } // for
+    // calculate the time bins
+    STFT::timeBins.clear();
+    for (int f = 0; f < numFrames; f++) {
+        STFT::timeBins.push_back(((float) f * STFT::hopLen)/(STFT::samplingFreq));
+    } // for
+
+    // each frame is windowed into its own row of the result, which
+    // is wide enough for the whole FFT, and transformed there as a batch
+    STFT::result.resize(numFrames, bins, windowLen);
+    int stride = STFT::result.getFrameStride();
+
+    std::function<void(int, int, int)> transform = [&](int worker, int begin, int end) {
+        for (int f = begin; f < end; f++) {
+            frameIt.frame(f, &STFT::result(f, 0));
         } // for
-        
 
-        // decimate signal in time
-        FFT::computeDit(&subSignal,windowLen);
+        // decimate signal in time and compute butterflies in place
+        const FFTPlan &workerPlan = STFT::pool ? STFT::workerPlans[worker] : plan;
+        workerPlan.executeBatch(&STFT::result(begin, 0), end - begin, stride);
+    };
 
-        // compute butterflies
-        for (int n = 2; n <= windowLen; n*=2) {
-            for (int k = 0; k < windowLen/n; k++) {
-                STFT::nPointButterfly(&subSignal,k,n);
-            } // for
+    STFT::runFrames(plan, numFrames, transform);
+}
+
+void STFT::computeSTFT(std::vector<float> *signal) {
+    // the input is real, so each frame only needs
+    // a windowLen/2 + 1 bin real-input FFT
+    const RealFFTPlan &plan = FFT::getRealPlan(STFT::windowLen);
+
+    int len = FFT::getFFTLen();
+    int binStride = windowLen/2 + 1;
+
+    const float *window = STFT::windowCoeffs ? STFT::windowCoeffs->data() : 0;
+
+    FrameIterator<float> frameIt(signal->data(), signal->size(), len, STFT::hopLen,
+        window, windowLen);
+    int numFrames = frameIt.getFrameCount();
+
+    // calculate the time bins
+    STFT::timeBins.clear();
+    for (int f = 0; f < numFrames; f++) {
+        STFT::timeBins.push_back(((float) f * STFT::hopLen)/(STFT::samplingFreq));
+    } // for
+
+    // each real frame is packed into the front of its own row of the result
+    STFT::result.resize(numFrames, ignoreNquist ? windowLen : windowLen/2, binStride);
+    int stride = STFT::result.getFrameStride();
+
+    std::function<void(int, int, int)> transform = [&](int worker, int begin, int end) {
+        for (int f = begin; f < end; f++) {
+            frameIt.frame(f, (float*) &STFT::result(f, 0));
         } // for
 
+        const RealFFTPlan &workerPlan = STFT::pool ? STFT::workerRealPlans[worker] : plan;
+        std::complex<float> *start = &STFT::result(begin, 0);
+        workerPlan.executeBatch((float*) start, 2 * stride, start, stride, end - begin);
+
         if (ignoreNquist) {
-            STFT::result.push_back(subSignal);
-        } else {
-            vector<std::complex<float>> halfSignal(subSignal.begin(), subSignal.begin() + windowLen/2);
-            STFT::result.push_back(halfSignal);
-        } // else
-    } // for
+            // the upper half is the conjugate of the lower half
+            for (int f = begin; f < end; f++) {
+                for (int k = 1; k < windowLen/2; k++) {
+                    STFT::result(f, windowLen - k) = std::conj(STFT::result(f, k));
+                } // for
+            } // for
+        } // if
+    };
+
+    STFT::runFrames(plan, numFrames, transform);
+}
+
+void STFT::setThreadCount(int threads) {
+    if (threads == 1) {
+        STFT::pool.reset();
+    } else {
+        STFT::pool = std::make_shared<ThreadPool>(threads);
+    } // else
+
+    STFT::workerPlans.clear();
+    STFT::workerRealPlans.clear();
+}
+
+int STFT::getThreadCount() {
+    return STFT::pool ? STFT::pool->getThreadCount() : 1;
+}
+
+void STFT::runFrames(const FFTPlan &plan, int numFrames, const std::function<void(int, int, int)> &transform) {
+    if (numFrames <= 0) {
+        return;
+    } // if
+
+    if (!STFT::pool) {
+        transform(0, 0, numFrames);
+        return;
+    } // if
+
+    // plans that are not a power of two keep a work buffer,
+    // so every worker transforms with its own copy
+    int threads = STFT::pool->getThreadCount();
+    if (STFT::workerPlans.size() != threads || STFT::workerPlans[0].getFFTLen() != plan.getFFTLen()) {
+        STFT::workerPlans.assign(threads, plan);
+    } // if
+
+    STFT::pool->parallelFor(numFrames, STFT::frameGrain, transform);
+}
+
+void STFT::runFrames(const RealFFTPlan &plan, int numFrames, const std::function<void(int, int, int)> &transform) {
+    if (numFrames <= 0) {
+        return;
+    } // if
+
+    if (!STFT::pool) {
+        transform(0, 0, numFrames);
+        return;
+    } // if
+
+    int threads = STFT::pool->getThreadCount();
+    if (STFT::workerRealPlans.size() != threads || STFT::workerRealPlans[0].getFFTLen() != plan.getFFTLen()) {
+        STFT::workerRealPlans.assign(threads, plan);
+    } // if
+
+    STFT::pool->parallelFor(numFrames, STFT::frameGrain, transform);
 }
 
 std::vector<float> STFT::getFreqBins() {
@@ -98,16 +212,37 @@ std::vector<float> STFT::getTimeBins() {
     return STFT::timeBins;
 }
 
-std::vector<std::vector<std::complex<float>>> STFT::getResult() {
+const Spectrogram<std::complex<float>> &STFT::getSpectrogram() const {
     return STFT::result;
 }
 
+Spectrogram<float> STFT::getMagSpectrogram() const {
+    Spectrogram<float> mag(STFT::result.getFrameCount(), STFT::result.getBinCount());
+    for (int i = 0; i < STFT::result.getFrameCount(); i++) {
+        for (int j = 0; j < STFT::result.getBinCount(); j++) {
+            mag(i, j) = std::abs(STFT::result(i, j));
+        } // for
+    } // for
+
+    return mag;
+}
+
+std::vector<std::vector<std::complex<float>>> STFT::getResult() {
+    std::vector<std::vector<std::complex<float>>> res;
+    for (int i = 0; i < STFT::result.getFrameCount(); i++) {
+        StridedSpan<std::complex<float>> frame = STFT::result.row(i);
+        res.push_back(std::vector<std::complex<float>>(frame.data(), frame.data() + frame.size()));
+    } // for
+
+    return res;
+}
+
 std::vector<std::vector<float>> STFT::getMagResult() {
     std::vector<std::vector<float>> abs;
-    for (int i = 0; i < STFT::result.size(); i++) {
+    for (int i = 0; i < STFT::result.getFrameCount(); i++) {
         std::vector<float> abs_vec;
-        for (int j = 0; j < STFT::result[i].size(); j++) {
-            abs_vec.push_back(std::abs(STFT::result[i][j]));
+        for (int j = 0; j < STFT::result.getBinCount(); j++) {
+            abs_vec.push_back(std::abs(STFT::result(i, j)));
         } // for
         abs.push_back(abs_vec);
     } // for
@@ -5,41 +5,119 @@
 #include <map>
 #include <vector>
 #include <string>
+#include <functional>
+#include <memory>
 #include "fft.h"
+#include "fftplan.h"
 #include "filter.h"
+#include "spectrogram.h"
+#include "alignedbuffer.h"
+#include "threadpool.h"
 
 class STFT : public FFT, public Filter {
     public:
         /**
          * @brief Construct a new STFT object
          * 
-         * @param windowLen Length of single FFT (if larger than fftLen, sequence is zero padded) Must be power of two.
+         * @param windowLen Length of single FFT (if larger than fftLen, sequence is zero padded). Any length,
+         * though lengths with only factors of 2, 3, 5 and 7 are fastest, and real signals need an even length.
          * @param samplingFreq Sampling frequency (Hz)
-         * @param fftLen Length of FFT. Must be power of two.
+         * @param fftLen Length of FFT
          * @param ignoreNquist If Nquist is ignored the full spectrum is returned, otherwise spectrum is samplingFreq/2
-         * @param window Type of window. "hamm" or "none".
+         * @param window Type of window. "hamm", "hann", "blackmanharris", "kaiser", "flattop" or "none".
+         * @param hopLen Number of samples between the start of consecutive frames, e.g. fftLen/2
+         * for 50% overlap. Defaults to fftLen, where frames do not overlap.
          */
-        STFT(int windowLen, int samplingFreq, int fftLen, bool ignoreNquist, std::string window="hamm");
+        STFT(int windowLen, int samplingFreq, int fftLen, bool ignoreNquist, std::string window="hamm", int hopLen=0);
         
         ~STFT();
 
         /**
          * @brief This function truncates a signal of arbitrary length
-         * to a power of 2 for the FFT
+         * to a multiple of fftLen
          * 
          * @param signal 
          */
         void fitSignal(std::vector<std::complex<float>> *signal);
 
         /**
-         * @brief Computes the STFT of a given signal
+         * @brief This function truncates a real signal of arbitrary length
+         * to a multiple of fftLen
+         * 
+         * @param signal 
+         */
+        void fitSignal(std::vector<float> *signal);
+
+        /**
+         * @brief Set the number of samples between the start of consecutive frames,
+         * so the time resolution can change without a new STFT object
+         * 
+         * @param hopLen Hop length, or <= 0 for fftLen (no overlap)
+         */
+        void setHopLen(int hopLen);
+
+        /**
+         * @brief Gets the number of samples between the start of consecutive frames
+         * 
+         * @return int 
+         */
+        int getHopLen();
+
+        /**
+         * @brief Computes the STFT of a given signal. Every whole frame of fftLen
+         * samples, advancing by hopLen, is windowed directly from the signal.
+         * The result and time bins replace those of any previous call; use
+         * StreamingSTFT for signals that arrive in chunks.
          * 
          * @param signal 
          */
         void computeSTFT(std::vector<std::complex<float>> *signal);
 
         /**
-         * @brief Get the result from the STFT computation, returns
+         * @brief Computes the STFT of a given real signal. Each frame is transformed
+         * with a real-input FFT, which only computes the windowLen/2 + 1 non-redundant
+         * bins; with ignoreNquist the upper half is filled in by conjugate symmetry.
+         * The result and time bins replace those of any previous call.
+         * 
+         * @param signal 
+         */
+        void computeSTFT(std::vector<float> *signal);
+
+        /**
+         * @brief Set the number of threads the STFT frames are computed on.
+         * The frames are independent, so they are spread over a reusable
+         * work-stealing thread pool, and the result is bit-identical to a
+         * single thread.
+         * 
+         * @param threads Number of threads, 1 (default) to compute on the calling
+         * thread, or <= 0 for the hardware concurrency
+         */
+        void setThreadCount(int threads);
+
+        /**
+         * @brief Gets the number of threads the STFT frames are computed on
+         * 
+         * @return int 
+         */
+        int getThreadCount();
+
+        /**
+         * @brief Get the result from the STFT computation, without copying it.
+         * Frames are rows and frequency bins are columns.
+         * 
+         * @return const Spectrogram<std::complex<float>>& 
+         */
+        const Spectrogram<std::complex<float>> &getSpectrogram() const;
+
+        /**
+         * @brief Get the magnitude of the result from the STFT computation
+         * 
+         * @return Spectrogram<float> 
+         */
+        Spectrogram<float> getMagSpectrogram() const;
+
+        /**
+         * @brief Get a copy of the result from the STFT computation, returns
          * a 2d complex vector
          * 
          * @return std::vector<std::vector<std::complex<float>>> 
@@ -47,7 +125,7 @@ class STFT : public FFT, public Filter {
         std::vector<std::vector<std::complex<float>>> getResult();
 
         /**
-         * @brief Get the magnitude result from the STFT computation,
+         * @brief Get a copy of the magnitude result from the STFT computation,
          * returns a 2d float vector
          * 
          * @return std::vector<std::vector<float>> 
@@ -69,16 +147,29 @@ class STFT : public FFT, public Filter {
         std::vector<float> getTimeBins();
     
     private:
+        void runFrames(const FFTPlan &plan, int numFrames, const std::function<void(int, int, int)> &transform);
+        void runFrames(const RealFFTPlan &plan, int numFrames, const std::function<void(int, int, int)> &transform);
+
+        // frames handed to a worker at a time
+        static const int frameGrain = 16;
+
         int windowLen;
         int samplingFreq;
         int fftLen;
+        int hopLen;
         bool zeroPadding;
         bool ignoreNquist;
         std::string window;
+        // first fftLen points of the fftLen + 1 point window, shared with the WindowCache
+        std::shared_ptr<const AlignedBuffer<float>> windowCoeffs;
         
-        std::vector<std::vector<std::complex<float>>> result;
+        Spectrogram<std::complex<float>> result;
         std::vector<float> freqBins;
         std::vector<float> timeBins;
+
+        std::shared_ptr<ThreadPool> pool;
+        std::vector<FFTPlan> workerPlans;
+        std::vector<RealFFTPlan> workerRealPlans;
 };
 
 #endif // STFT_H
\ No newline at end of file
@@ -0,0 +1,169 @@
+#include <complex>
+#include <string>
+#include <algorithm>
+#include <stdexcept>
+#include "streamingstft.h"
+#include "windowcache.h"
+
+using namespace std;
+
+StreamingSTFT::StreamingSTFT(int windowLen, int samplingFreq, int fftLen, bool ignoreNquist, std::string window, int hopLen) :
+windowLen(windowLen), samplingFreq(samplingFreq), fftLen(fftLen), window(window), plan(windowLen), maxQueuedFrames(1024) {
+    StreamingSTFT::hopLen = hopLen > 0 ? hopLen : fftLen;
+    StreamingSTFT::bins = ignoreNquist ? windowLen : windowLen/2;
+
+    WindowCache::Type type = WindowCache::parseType(window);
+    if (type != WindowCache::RECTANGULAR) {
+        StreamingSTFT::windowCoeffs = WindowCache::get(type, fftLen+1, WindowCache::defaultKaiserBeta);
+    } // if
+
+    for (int i = 0; i < StreamingSTFT::bins; i++) {
+        StreamingSTFT::freqBins.push_back(i*((float)samplingFreq/windowLen));
+    } // for
+
+    // real samples are transformed by a half length FFT, which needs an even length
+    if (windowLen >= 2 && windowLen % 2 == 0) {
+        StreamingSTFT::realPlan = std::make_shared<RealFFTPlan>(windowLen);
+        StreamingSTFT::realRing.resize(fftLen);
+        StreamingSTFT::realFrame.resize(windowLen);
+    } // if
+
+    StreamingSTFT::ring.resize(fftLen);
+    StreamingSTFT::frame.resize(windowLen);
+    StreamingSTFT::reset();
+}
+
+StreamingSTFT::~StreamingSTFT() { }
+
+void StreamingSTFT::setCallback(Callback callback) {
+    StreamingSTFT::callback = callback;
+}
+
+void StreamingSTFT::setMaxQueuedFrames(int frames) {
+    StreamingSTFT::maxQueuedFrames = std::max(1, frames);
+    while (StreamingSTFT::queue.size() > StreamingSTFT::maxQueuedFrames) {
+        StreamingSTFT::queue.pop_front();
+    } // while
+}
+
+void StreamingSTFT::reset() {
+    std::fill(StreamingSTFT::ring.begin(), StreamingSTFT::ring.end(), std::complex<float>(0, 0));
+    std::fill(StreamingSTFT::realRing.begin(), StreamingSTFT::realRing.end(), 0.0f);
+    StreamingSTFT::input = NO_INPUT;
+    StreamingSTFT::writePos = 0;
+    StreamingSTFT::untilNextFrame = StreamingSTFT::fftLen;
+    StreamingSTFT::frameCount = 0;
+    StreamingSTFT::queue.clear();
+}
+
+void StreamingSTFT::push(const std::complex<float> *samples, int count) {
+    StreamingSTFT::pushSamples(samples, count, StreamingSTFT::ring, COMPLEX_INPUT);
+}
+
+void StreamingSTFT::push(const float *samples, int count) {
+    if (StreamingSTFT::realPlan) {
+        StreamingSTFT::pushSamples(samples, count, StreamingSTFT::realRing, REAL_INPUT);
+    } else {
+        StreamingSTFT::pushSamples(samples, count, StreamingSTFT::ring, REAL_INPUT);
+    } // else
+}
+
+template <typename T, typename R>
+void StreamingSTFT::pushSamples(const T *samples, int count, std::vector<R> &ring, Input input) {
+    if (StreamingSTFT::input != input && StreamingSTFT::input != NO_INPUT) {
+        throw std::invalid_argument("StreamingSTFT: real and complex samples cannot be mixed in one stream");
+    } // if
+    StreamingSTFT::input = input;
+
+    while (count > 0) {
+        // copy up to the next frame boundary or the end of the ring
+        int n = std::min(count, std::min(StreamingSTFT::untilNextFrame, StreamingSTFT::fftLen - StreamingSTFT::writePos));
+        std::copy(samples, samples + n, ring.begin() + StreamingSTFT::writePos);
+
+        samples += n;
+        count -= n;
+        StreamingSTFT::writePos = (StreamingSTFT::writePos + n) % StreamingSTFT::fftLen;
+        StreamingSTFT::untilNextFrame -= n;
+
+        if (StreamingSTFT::untilNextFrame == 0) {
+            StreamingSTFT::emitFrame();
+            StreamingSTFT::untilNextFrame = StreamingSTFT::hopLen;
+        } // if
+    } // while
+}
+
+template <typename T>
+void StreamingSTFT::copyFrame(const std::vector<T> &ring, T *frame) {
+    int len = std::min(StreamingSTFT::fftLen, StreamingSTFT::windowLen);
+
+    // the ring is full, so the oldest sample is at writePos
+    for (int i = 0; i < len; i++) {
+        int idx = StreamingSTFT::writePos + i;
+        if (idx >= StreamingSTFT::fftLen) {
+            idx -= StreamingSTFT::fftLen;
+        } // if
+        frame[i] = ring[idx];
+    } // for
+
+    // add the window function
+    if (StreamingSTFT::windowCoeffs) {
+        const float *window = StreamingSTFT::windowCoeffs->data();
+        for (int i = 0; i < len; i++) {
+            frame[i] *= window[i];
+        } // for
+    } // if
+
+    // add zero padded tokens
+    std::fill(frame + len, frame + StreamingSTFT::windowLen, T(0));
+}
+
+void StreamingSTFT::emitFrame() {
+    if (StreamingSTFT::input == REAL_INPUT && StreamingSTFT::realPlan) {
+        StreamingSTFT::copyFrame(StreamingSTFT::realRing, &StreamingSTFT::realFrame[0]);
+        StreamingSTFT::realPlan->execute(&StreamingSTFT::realFrame[0], &StreamingSTFT::frame[0]);
+
+        // the upper half is the conjugate of the lower half
+        if (StreamingSTFT::bins == StreamingSTFT::windowLen) {
+            for (int k = 1; k < StreamingSTFT::windowLen/2; k++) {
+                StreamingSTFT::frame[StreamingSTFT::windowLen - k] = std::conj(StreamingSTFT::frame[k]);
+            } // for
+        } // if
+    } else {
+        StreamingSTFT::copyFrame(StreamingSTFT::ring, &StreamingSTFT::frame[0]);
+        StreamingSTFT::plan.execute(&StreamingSTFT::frame[0]);
+    } // else
+
+    float time = ((float) StreamingSTFT::frameCount * StreamingSTFT::hopLen) / StreamingSTFT::samplingFreq;
+    StreamingSTFT::frameCount++;
+
+    if (StreamingSTFT::callback) {
+        StreamingSTFT::callback(&StreamingSTFT::frame[0], StreamingSTFT::bins, time);
+    } else {
+        // drop the oldest spectrum rather than grow without bound
+        if (StreamingSTFT::queue.size() >= StreamingSTFT::maxQueuedFrames) {
+            StreamingSTFT::queue.pop_front();
+        } // if
+        StreamingSTFT::queue.push_back(std::make_pair(time,
+            std::vector<std::complex<float>>(StreamingSTFT::frame.begin(), StreamingSTFT::frame.begin() + StreamingSTFT::bins)));
+    } // else
+}
+
+bool StreamingSTFT::pop(std::vector<std::complex<float>> &spectrum, float &time) {
+    if (StreamingSTFT::queue.empty()) {
+        return false;
+    } // if
+
+    time = StreamingSTFT::queue.front().first;
+    spectrum.swap(StreamingSTFT::queue.front().second);
+    StreamingSTFT::queue.pop_front();
+
+    return true;
+}
+
+int StreamingSTFT::getQueuedFrames() {
+    return StreamingSTFT::queue.size();
+}
+
+std::vector<float> StreamingSTFT::getFreqBins() {
+    return StreamingSTFT::freqBins;
+}
@@ -0,0 +1,149 @@
+#ifndef STREAMINGSTFT_H
+#define STREAMINGSTFT_H
+
+#include <complex>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include "fftplan.h"
+#include "alignedbuffer.h"
+
+class StreamingSTFT {
+    public:
+        /**
+         * @brief Called with each completed spectrum, which is only valid during the call
+         *
+         * @param spectrum Spectrum of the frame
+         * @param bins Number of bins in the spectrum
+         * @param time Time of the start of the frame (s)
+         */
+        typedef std::function<void(const std::complex<float> *spectrum, int bins, float time)> Callback;
+
+        /**
+         * @brief Construct a new StreamingSTFT object. Samples are pushed in chunks of
+         * any size, and partial frames are carried over between chunks in a ring buffer,
+         * so memory use only depends on the window, not on the length of the stream.
+         *
+         * @param windowLen Length of single FFT (if larger than fftLen, sequence is zero padded)
+         * @param samplingFreq Sampling frequency (Hz)
+         * @param fftLen Length of FFT
+         * @param ignoreNquist If Nquist is ignored the full spectrum is returned, otherwise spectrum is samplingFreq/2
+         * @param window Type of window. "hamm", "hann", "blackmanharris", "kaiser", "flattop" or "none".
+         * @param hopLen Number of samples between the start of consecutive frames. Defaults to fftLen.
+         */
+        StreamingSTFT(int windowLen, int samplingFreq, int fftLen, bool ignoreNquist, std::string window="hamm", int hopLen=0);
+
+        ~StreamingSTFT();
+
+        /**
+         * @brief Set the callback completed spectra are emitted to. Without a
+         * callback they are queued until read with pop().
+         *
+         * @param callback
+         */
+        void setCallback(Callback callback);
+
+        /**
+         * @brief Set the most spectra queued without a callback. Once the queue
+         * is full the oldest spectrum is dropped for each new one, so callers
+         * that cannot keep up lose the oldest frames rather than run out of memory.
+         *
+         * @param frames Largest number of queued spectra. Defaults to 1024.
+         */
+        void setMaxQueuedFrames(int frames);
+
+        /**
+         * @brief Pushes a chunk of samples into the stream, emitting a spectrum
+         * for every frame completed by the chunk
+         *
+         * @param samples
+         * @param count Number of samples
+         */
+        void push(const std::complex<float> *samples, int count);
+
+        /**
+         * @brief Pushes a chunk of real samples into the stream, emitting a spectrum
+         * for every frame completed by the chunk. For an even windowLen the frames
+         * are transformed by a real-input FFT. A stream holds either real or
+         * complex samples until reset(); pushing the other kind throws.
+         *
+         * @param samples
+         * @param count Number of samples
+         */
+        void push(const float *samples, int count);
+
+        /**
+         * @brief Takes the oldest queued spectrum
+         *
+         * @param spectrum Set to the spectrum
+         * @param time Set to the time of the start of the frame (s)
+         * @return true if a spectrum was queued
+         */
+        bool pop(std::vector<std::complex<float>> &spectrum, float &time);
+
+        /**
+         * @brief Gets the number of queued spectra
+         *
+         * @return int
+         */
+        int getQueuedFrames();
+
+        /**
+         * @brief Discards all buffered samples and queued spectra, and restarts the stream at time 0
+         *
+         */
+        void reset();
+
+        /**
+         * @brief Get the freq bins given the STFT parameters
+         *
+         * @return std::vector<float>
+         */
+        std::vector<float> getFreqBins();
+
+    private:
+        enum Input {NO_INPUT, REAL_INPUT, COMPLEX_INPUT};
+
+        // copies a chunk into the ring, emitting each completed frame
+        template <typename T, typename R>
+        void pushSamples(const T *samples, int count, std::vector<R> &ring, Input input);
+
+        // unwraps the ring into the front of frame, windowed and zero padded
+        template <typename T>
+        void copyFrame(const std::vector<T> &ring, T *frame);
+
+        void emitFrame();
+
+        int windowLen;
+        int samplingFreq;
+        int fftLen;
+        int hopLen;
+        int bins;
+        std::string window;
+
+        FFTPlan plan;
+        // only for an even windowLen
+        std::shared_ptr<RealFFTPlan> realPlan;
+        std::shared_ptr<const AlignedBuffer<float>> windowCoeffs;
+        std::vector<float> freqBins;
+
+        // the last fftLen samples, oldest at writePos once full, in ring
+        // or realRing for the kind of samples pushed
+        std::vector<std::complex<float>> ring;
+        std::vector<float> realRing;
+        Input input;
+        int writePos;
+        // samples left before the next frame is complete
+        int untilNextFrame;
+        long long frameCount;
+
+        std::vector<std::complex<float>> frame;
+        std::vector<float> realFrame;
+        Callback callback;
+        std::deque<std::pair<float, std::vector<std::complex<float>>>> queue;
+        int maxQueuedFrames;
+};
+
+#endif // STREAMINGSTFT_H
@@ -0,0 +1,184 @@
+#include <thread>
+#include <mutex>
+#include <algorithm>
+#include "threadpool.h"
+
+using namespace std;
+
+ThreadPool::ThreadPool(int threads) :
+threads(threads), generation(0), active(0), stopping(false), task(0), grain(1) {
+    if (ThreadPool::threads <= 0) {
+        ThreadPool::threads = std::max(1, (int) std::thread::hardware_concurrency());
+    } // if
+
+    ThreadPool::ranges.reset(new Range[ThreadPool::threads]);
+
+    for (int w = 0; w < ThreadPool::threads; w++) {
+        ThreadPool::ranges[w].begin = 0;
+        ThreadPool::ranges[w].end = 0;
+    } // for
+
+    // worker 0 is the thread calling parallelFor
+    for (int w = 1; w < ThreadPool::threads; w++) {
+        ThreadPool::workers.push_back(std::thread(&ThreadPool::workerLoop, this, w));
+    } // for
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(ThreadPool::mutex);
+        ThreadPool::stopping = true;
+    }
+    ThreadPool::wake.notify_all();
+
+    for (int w = 0; w < ThreadPool::workers.size(); w++) {
+        ThreadPool::workers[w].join();
+    } // for
+}
+
+int ThreadPool::getThreadCount() const {
+    return ThreadPool::threads;
+}
+
+void ThreadPool::parallelFor(int count, int grain, const std::function<void(int, int, int)> &task) {
+    if (count <= 0) {
+        return;
+    } // if
+
+    if (ThreadPool::threads == 1) {
+        task(0, 0, count);
+        return;
+    } // if
+
+    // give every worker an equal share of the range
+    for (int w = 0; w < ThreadPool::threads; w++) {
+        std::lock_guard<std::mutex> lock(ThreadPool::ranges[w].mutex);
+        ThreadPool::ranges[w].begin = (int) (((long long) count * w) / ThreadPool::threads);
+        ThreadPool::ranges[w].end = (int) (((long long) count * (w + 1)) / ThreadPool::threads);
+    } // for
+
+    {
+        std::lock_guard<std::mutex> lock(ThreadPool::mutex);
+        ThreadPool::task = &task;
+        ThreadPool::grain = std::max(1, grain);
+        ThreadPool::error = std::exception_ptr();
+        ThreadPool::active = ThreadPool::threads - 1;
+        ThreadPool::generation++;
+    }
+    ThreadPool::wake.notify_all();
+
+    ThreadPool::runWorker(0);
+
+    std::exception_ptr error;
+    {
+        std::unique_lock<std::mutex> lock(ThreadPool::mutex);
+        ThreadPool::done.wait(lock, [this] { return ThreadPool::active == 0; });
+        ThreadPool::task = 0;
+        error = ThreadPool::error;
+    }
+
+    if (error) {
+        std::rethrow_exception(error);
+    } // if
+}
+
+void ThreadPool::workerLoop(int worker) {
+    unsigned seen = 0;
+
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(ThreadPool::mutex);
+            ThreadPool::wake.wait(lock, [&] { return ThreadPool::stopping || ThreadPool::generation != seen; });
+            if (ThreadPool::stopping) {
+                return;
+            } // if
+            seen = ThreadPool::generation;
+        }
+
+        ThreadPool::runWorker(worker);
+
+        {
+            std::lock_guard<std::mutex> lock(ThreadPool::mutex);
+            if (--ThreadPool::active == 0) {
+                ThreadPool::done.notify_all();
+            } // if
+        }
+    } // for
+}
+
+void ThreadPool::runWorker(int worker) {
+    int begin, end;
+
+    while (ThreadPool::takeChunk(worker, begin, end) || (ThreadPool::steal(worker) && ThreadPool::takeChunk(worker, begin, end))) {
+        try {
+            (*ThreadPool::task)(worker, begin, end);
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(ThreadPool::mutex);
+            if (!ThreadPool::error) {
+                ThreadPool::error = std::current_exception();
+            } // if
+        } // catch
+    } // while
+}
+
+bool ThreadPool::takeChunk(int worker, int &begin, int &end) {
+    Range &own = ThreadPool::ranges[worker];
+    std::lock_guard<std::mutex> lock(own.mutex);
+
+    if (own.begin >= own.end) {
+        return false;
+    } // if
+
+    begin = own.begin;
+    end = std::min(own.begin + ThreadPool::grain, own.end);
+    own.begin = end;
+
+    return true;
+}
+
+bool ThreadPool::steal(int worker) {
+    for (;;) {
+        // pick the worker with the most work left
+        int victim = -1;
+        int most = 0;
+        for (int w = 0; w < ThreadPool::threads; w++) {
+            if (w == worker) {
+                continue;
+            } // if
+
+            std::lock_guard<std::mutex> lock(ThreadPool::ranges[w].mutex);
+            int left = ThreadPool::ranges[w].end - ThreadPool::ranges[w].begin;
+            if (left > most) {
+                most = left;
+                victim = w;
+            } // if
+        } // for
+
+        if (victim < 0) {
+            return false;
+        } // if
+
+        int begin, end;
+        {
+            Range &other = ThreadPool::ranges[victim];
+            std::lock_guard<std::mutex> lock(other.mutex);
+
+            // the victim may have finished since the scan
+            if (other.begin >= other.end) {
+                continue;
+            } // if
+
+            // take the back half, or all of it when only a chunk is left
+            end = other.end;
+            begin = other.end - other.begin > ThreadPool::grain ? other.begin + (other.end - other.begin)/2 : other.begin;
+            other.end = begin;
+        }
+
+        Range &own = ThreadPool::ranges[worker];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        own.begin = begin;
+        own.end = end;
+
+        return true;
+    } // for
+}
@@ -0,0 +1,73 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class ThreadPool {
+    public:
+        /**
+         * @brief Construct a new thread pool. The calling thread of parallelFor
+         * works as one of the workers, so threads - 1 threads are started here
+         * and reused for every parallelFor call.
+         *
+         * @param threads Number of workers, or the hardware concurrency if <= 0
+         */
+        ThreadPool(int threads);
+
+        ~ThreadPool();
+
+        /**
+         * @brief Gets the number of workers, including the calling thread
+         *
+         * @return int
+         */
+        int getThreadCount() const;
+
+        /**
+         * @brief Runs task over the index range [0, count) and blocks until it
+         * completes. Each worker starts on an equal share of the range and takes
+         * grain sized chunks from it, and a worker that runs out steals the back
+         * half of the largest remaining share. The first exception thrown by
+         * task is rethrown here once all workers have stopped.
+         *
+         * @param count Number of indices
+         * @param grain Largest number of indices per call of task
+         * @param task Called as task(worker, begin, end), with worker in [0, getThreadCount())
+         */
+        void parallelFor(int count, int grain, const std::function<void(int, int, int)> &task);
+
+    private:
+        struct Range {
+            std::mutex mutex;
+            int begin;
+            int end;
+        };
+
+        void workerLoop(int worker);
+        void runWorker(int worker);
+        bool takeChunk(int worker, int &begin, int &end);
+        bool steal(int worker);
+
+        int threads;
+        std::vector<std::thread> workers;
+        std::unique_ptr<Range[]> ranges;
+
+        std::mutex mutex;
+        std::condition_variable wake;
+        std::condition_variable done;
+        unsigned generation;
+        int active;
+        bool stopping;
+
+        const std::function<void(int, int, int)> *task;
+        int grain;
+        std::exception_ptr error;
+};
+
+#endif // THREADPOOL_H
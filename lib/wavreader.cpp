@@ -0,0 +1,290 @@
+#include <cstring>
+#include <cstdint>
+#include <algorithm>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "wavreader.h"
+#include "simd.h"
+
+using namespace std;
+
+namespace {
+
+// consumed bytes are released in steps of at least this, to keep the calls rare
+const long long releaseStep = 8 << 20;
+
+unsigned int readU16(const unsigned char *p) {
+    return p[0] | (p[1] << 8);
+}
+
+unsigned int readU32(const unsigned char *p) {
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((unsigned int) p[3] << 24);
+}
+
+unsigned long long readU64(const unsigned char *p) {
+    return readU32(p) | ((unsigned long long) readU32(p + 4) << 32);
+}
+
+// converts count samples, step samples apart, to floats in [-1, 1), the
+// common formats a register at a time
+void convert(WavReader::Format format, const unsigned char *in, int step, float *out, int count) {
+    switch (format) {
+        case WavReader::PCM_INT16:
+            Simd::convertInt16(in, step, out, count);
+            break;
+        case WavReader::PCM_INT24: {
+            const float scale = 1.0f / 8388608;
+            for (int i = 0; i < count; i++) {
+                const unsigned char *p = in + 3 * step * i;
+                // into the top three bytes, so the shift extends the sign
+                int32_t v = (int32_t) ((uint32_t) p[0] << 8 | (uint32_t) p[1] << 16 | (uint32_t) p[2] << 24) >> 8;
+                out[i] = v * scale;
+            } // for
+            break;
+        }
+        case WavReader::PCM_INT32: {
+            const float scale = 1.0f / 2147483648.0f;
+            for (int i = 0; i < count; i++) {
+                int32_t v;
+                memcpy(&v, in + 4 * step * i, 4);
+                out[i] = v * scale;
+            } // for
+            break;
+        }
+        case WavReader::FLOAT32:
+            Simd::convertFloat32(in, step, out, count);
+            break;
+    } // switch
+}
+
+} // namespace
+
+WavReader::WavReader(const std::string &path) :
+fd(-1), map(0), mapLen(0), position(0), released(0) {
+    WavReader::open(path);
+
+    try {
+        WavReader::parseHeader();
+    } catch (...) {
+        WavReader::unmap();
+        throw;
+    } // catch
+}
+
+WavReader::WavReader(const std::string &path, Format format, int channels, int samplingFreq) :
+fd(-1), map(0), mapLen(0), position(0), released(0) {
+    WavReader::open(path);
+
+    try {
+        WavReader::data = WavReader::map;
+        WavReader::dataLen = WavReader::mapLen;
+        WavReader::setFormat(format, channels, samplingFreq);
+    } catch (...) {
+        WavReader::unmap();
+        throw;
+    } // catch
+}
+
+WavReader::~WavReader() {
+    WavReader::unmap();
+}
+
+void WavReader::unmap() {
+    if (WavReader::map) {
+        munmap((void *) WavReader::map, WavReader::mapLen);
+        WavReader::map = 0;
+    } // if
+    if (WavReader::fd >= 0) {
+        close(WavReader::fd);
+        WavReader::fd = -1;
+    } // if
+}
+
+int WavReader::read(float *samples, int frames) {
+    frames = (int) std::max(0LL, std::min((long long) frames, WavReader::frameCount - WavReader::position));
+
+    const unsigned char *in = WavReader::data + WavReader::position * WavReader::channels * WavReader::sampleBytes;
+    convert(WavReader::format, in, 1, samples, frames * WavReader::channels);
+
+    WavReader::position += frames;
+    WavReader::release();
+
+    return frames;
+}
+
+int WavReader::readChannel(float *samples, int frames, int channel) {
+    if (channel < 0 || channel >= WavReader::channels) {
+        throw std::invalid_argument("WavReader: channel out of range");
+    } // if
+
+    frames = (int) std::max(0LL, std::min((long long) frames, WavReader::frameCount - WavReader::position));
+
+    const unsigned char *in = WavReader::data + (WavReader::position * WavReader::channels + channel) * WavReader::sampleBytes;
+    convert(WavReader::format, in, WavReader::channels, samples, frames);
+
+    WavReader::position += frames;
+    WavReader::release();
+
+    return frames;
+}
+
+void WavReader::seek(long long frame) {
+    WavReader::position = std::max(0LL, std::min(frame, WavReader::frameCount));
+
+    // pages before the new position may be read again
+    long long page = sysconf(_SC_PAGESIZE);
+    long long offset = (WavReader::data - WavReader::map) + WavReader::position * WavReader::channels * WavReader::sampleBytes;
+    WavReader::released = std::min(WavReader::released, offset / page * page);
+}
+
+long long WavReader::getPosition() const {
+    return WavReader::position;
+}
+
+long long WavReader::getFrameCount() const {
+    return WavReader::frameCount;
+}
+
+int WavReader::getChannels() const {
+    return WavReader::channels;
+}
+
+int WavReader::getSamplingFreq() const {
+    return WavReader::samplingFreq;
+}
+
+WavReader::Format WavReader::getFormat() const {
+    return WavReader::format;
+}
+
+void WavReader::open(const std::string &path) {
+    WavReader::fd = ::open(path.c_str(), O_RDONLY);
+    if (WavReader::fd < 0) {
+        throw std::runtime_error("WavReader: cannot open " + path);
+    } // if
+
+    struct stat info;
+    if (fstat(WavReader::fd, &info) != 0) {
+        close(WavReader::fd);
+        throw std::runtime_error("WavReader: cannot read the size of " + path);
+    } // if
+
+    WavReader::mapLen = info.st_size;
+    if (WavReader::mapLen > 0) {
+        void *addr = mmap(0, WavReader::mapLen, PROT_READ, MAP_PRIVATE, WavReader::fd, 0);
+        if (addr == MAP_FAILED) {
+            close(WavReader::fd);
+            throw std::runtime_error("WavReader: cannot map " + path);
+        } // if
+
+        WavReader::map = (const unsigned char *) addr;
+        madvise(addr, WavReader::mapLen, MADV_SEQUENTIAL);
+    } // if
+}
+
+void WavReader::parseHeader() {
+    const unsigned char *p = WavReader::map;
+    long long len = WavReader::mapLen;
+
+    if (len < 12 || (memcmp(p, "RIFF", 4) != 0 && memcmp(p, "RF64", 4) != 0) || memcmp(p + 8, "WAVE", 4) != 0) {
+        throw std::invalid_argument("WavReader: not a WAV file");
+    } // if
+
+    // RF64 keeps the 64 bit data size in a ds64 chunk, ahead of the data chunk
+    unsigned long long ds64DataLen = 0;
+    int formatTag = -1;
+    int channels = 0;
+    int samplingFreq = 0;
+    int bits = 0;
+
+    long long pos = 12;
+    while (pos + 8 <= len) {
+        const unsigned char *chunk = p + pos;
+        unsigned long long size = readU32(chunk + 4);
+        const unsigned char *body = chunk + 8;
+        long long bodyLen = std::min((long long) size, len - pos - 8);
+
+        if (memcmp(chunk, "ds64", 4) == 0 && bodyLen >= 16) {
+            ds64DataLen = readU64(body + 8);
+        } else if (memcmp(chunk, "fmt ", 4) == 0 && bodyLen >= 16) {
+            formatTag = readU16(body);
+            channels = readU16(body + 2);
+            samplingFreq = readU32(body + 4);
+            bits = readU16(body + 14);
+
+            // WAVE_FORMAT_EXTENSIBLE gives the real tag at the start of its sub format
+            if (formatTag == 0xFFFE && bodyLen >= 26) {
+                formatTag = readU16(body + 24);
+            } // if
+        } else if (memcmp(chunk, "data", 4) == 0) {
+            if (formatTag < 0) {
+                throw std::invalid_argument("WavReader: data chunk before fmt chunk");
+            } // if
+
+            if (size == 0xFFFFFFFF && ds64DataLen > 0) {
+                size = ds64DataLen;
+            } // if
+
+            // streamed writers may leave the size unset, so never read past the file
+            WavReader::data = body;
+            WavReader::dataLen = (long long) std::min(size, (unsigned long long) (len - pos - 8));
+
+            if (formatTag == 1 && bits == 16) {
+                WavReader::setFormat(PCM_INT16, channels, samplingFreq);
+            } else if (formatTag == 1 && bits == 24) {
+                WavReader::setFormat(PCM_INT24, channels, samplingFreq);
+            } else if (formatTag == 1 && bits == 32) {
+                WavReader::setFormat(PCM_INT32, channels, samplingFreq);
+            } else if (formatTag == 3 && bits == 32) {
+                WavReader::setFormat(FLOAT32, channels, samplingFreq);
+            } else {
+                throw std::invalid_argument("WavReader: unsupported sample format");
+            } // else
+
+            return;
+        } // else if
+
+        // chunks are padded to an even length
+        pos += 8 + size + (size & 1);
+    } // while
+
+    throw std::invalid_argument("WavReader: no data chunk");
+}
+
+void WavReader::setFormat(Format format, int channels, int samplingFreq) {
+    if (channels <= 0 || samplingFreq <= 0) {
+        throw std::invalid_argument("WavReader: the channels and sampling frequency must be positive");
+    } // if
+
+    WavReader::format = format;
+    WavReader::channels = channels;
+    WavReader::samplingFreq = samplingFreq;
+
+    switch (format) {
+        case PCM_INT16:
+            WavReader::sampleBytes = 2;
+            break;
+        case PCM_INT24:
+            WavReader::sampleBytes = 3;
+            break;
+        default:
+            WavReader::sampleBytes = 4;
+            break;
+    } // switch
+
+    WavReader::frameCount = WavReader::dataLen / (channels * WavReader::sampleBytes);
+}
+
+void WavReader::release() {
+    long long page = sysconf(_SC_PAGESIZE);
+    long long offset = (WavReader::data - WavReader::map) + WavReader::position * WavReader::channels * WavReader::sampleBytes;
+    long long end = offset / page * page;
+
+    if (end - WavReader::released >= releaseStep) {
+        madvise((void *) (WavReader::map + WavReader::released), end - WavReader::released, MADV_DONTNEED);
+        WavReader::released = end;
+    } // if
+}
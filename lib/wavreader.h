@@ -0,0 +1,128 @@
+#ifndef WAVREADER_H
+#define WAVREADER_H
+
+#include <string>
+
+class WavReader {
+    public:
+        /**
+         * @brief Sample encodings that can be read
+         */
+        enum Format {PCM_INT16, PCM_INT24, PCM_INT32, FLOAT32};
+
+        /**
+         * @brief Construct a new WavReader object for a WAV (or RF64) file. The
+         * file is memory mapped rather than loaded, and samples are converted
+         * straight from the mapping as they are read; pages that have been read
+         * are released, so memory use stays constant however large the file.
+         *
+         * @param path Path of the file
+         */
+        WavReader(const std::string &path);
+
+        /**
+         * @brief Construct a new WavReader object for a headerless file of
+         * interleaved little endian samples
+         *
+         * @param path Path of the file
+         * @param format Encoding of the samples
+         * @param channels Number of interleaved channels
+         * @param samplingFreq Sampling frequency (Hz)
+         */
+        WavReader(const std::string &path, Format format, int channels, int samplingFreq);
+
+        ~WavReader();
+
+        /**
+         * @brief Reads frames from the current position as interleaved floats in
+         * [-1, 1), and advances the position
+         *
+         * @param samples frames * getChannels() values
+         * @param frames Number of frames to read
+         * @return int the number of frames read, less than frames at the end of the file
+         */
+        int read(float *samples, int frames);
+
+        /**
+         * @brief Reads one channel of frames from the current position as floats
+         * in [-1, 1), and advances the position
+         *
+         * @param samples frames values
+         * @param frames Number of frames to read
+         * @param channel Channel to read
+         * @return int the number of frames read, less than frames at the end of the file
+         */
+        int readChannel(float *samples, int frames, int channel=0);
+
+        /**
+         * @brief Moves the position to a frame
+         *
+         * @param frame
+         */
+        void seek(long long frame);
+
+        /**
+         * @brief Gets the position, the next frame to be read
+         *
+         * @return long long
+         */
+        long long getPosition() const;
+
+        /**
+         * @brief Gets the number of frames in the file
+         *
+         * @return long long
+         */
+        long long getFrameCount() const;
+
+        /**
+         * @brief Gets the number of channels
+         *
+         * @return int
+         */
+        int getChannels() const;
+
+        /**
+         * @brief Gets the sampling frequency (Hz)
+         *
+         * @return int
+         */
+        int getSamplingFreq() const;
+
+        /**
+         * @brief Gets the encoding of the samples
+         *
+         * @return Format
+         */
+        Format getFormat() const;
+
+    private:
+        WavReader(const WavReader &);
+        WavReader &operator=(const WavReader &);
+
+        void open(const std::string &path);
+        void parseHeader();
+        void setFormat(Format format, int channels, int samplingFreq);
+        // releases the pages before the position
+        void release();
+        void unmap();
+
+        int fd;
+        const unsigned char *map;
+        long long mapLen;
+
+        // the samples within the mapping
+        const unsigned char *data;
+        long long dataLen;
+
+        Format format;
+        int channels;
+        int samplingFreq;
+        int sampleBytes;
+        long long frameCount;
+        long long position;
+        // start of the pages not yet released
+        long long released;
+};
+
+#endif // WAVREADER_H
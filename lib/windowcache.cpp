@@ -0,0 +1,96 @@
+#include <cmath>
+#include <stdexcept>
+#include "windowcache.h"
+#include "filter.h"
+
+using namespace std;
+
+std::mutex WindowCache::mutex;
+std::map<std::pair<std::pair<int, int>, double>, std::shared_ptr<const AlignedBuffer<float>>> WindowCache::windows;
+
+std::shared_ptr<const AlignedBuffer<float>> WindowCache::get(Type type, int n, double param) {
+    if (n <= 0) {
+        throw std::invalid_argument("WindowCache: the window length must be positive");
+    } // if
+
+    if (type != KAISER) {
+        param = 0;
+    } // if
+
+    std::pair<std::pair<int, int>, double> key(std::make_pair((int) type, n), param);
+
+    std::lock_guard<std::mutex> lock(WindowCache::mutex);
+    std::shared_ptr<const AlignedBuffer<float>> &window = WindowCache::windows[key];
+    if (!window) {
+        window = WindowCache::compute(type, n, param);
+    } // if
+
+    return window;
+}
+
+WindowCache::Type WindowCache::parseType(const std::string &name) {
+    if (name == "none") {
+        return RECTANGULAR;
+    } else if (name == "hamm") {
+        return HAMMING;
+    } else if (name == "hann") {
+        return HANN;
+    } else if (name == "blackmanharris") {
+        return BLACKMAN_HARRIS;
+    } else if (name == "kaiser") {
+        return KAISER;
+    } else if (name == "flattop") {
+        return FLAT_TOP;
+    } // else
+
+    throw std::invalid_argument("WindowCache: unknown window " + name);
+}
+
+void WindowCache::clear() {
+    std::lock_guard<std::mutex> lock(WindowCache::mutex);
+    WindowCache::windows.clear();
+}
+
+std::vector<double> WindowCache::getCosineTerms(Type type) {
+    switch (type) {
+        case RECTANGULAR:
+            return {1};
+        case HAMMING:
+            return {0.54, -0.46};
+        case HANN:
+            return {0.5, -0.5};
+        case BLACKMAN_HARRIS:
+            return {0.35875, -0.48829, 0.14128, -0.01168};
+        case FLAT_TOP:
+            return {0.21557895, -0.41663158, 0.277263158, -0.083578947, 0.006947368};
+        default:
+            return {};
+    } // switch
+}
+
+std::shared_ptr<AlignedBuffer<float>> WindowCache::compute(Type type, int n, double param) {
+    std::shared_ptr<AlignedBuffer<float>> window = std::make_shared<AlignedBuffer<float>>(n);
+    AlignedBuffer<float> &w = *window;
+
+    Filter filter;
+    double kaiserNorm = type == KAISER ? filter.bessi0(param) : 1;
+    std::vector<double> terms = WindowCache::getCosineTerms(type);
+
+    for (int i = 0; i < n; i++) {
+        if (type == KAISER) {
+            // distance from the centre of the window, in [-1, 1)
+            double r = 2.0 * i / n - 1;
+            w[i] = filter.bessi0(param * sqrt(1 - r * r)) / kaiserNorm;
+            continue;
+        } // if
+
+        double x = 2 * M_PI * i / n;
+        double sum = terms[0];
+        for (int t = 1; t < terms.size(); t++) {
+            sum += terms[t] * cos(t * x);
+        } // for
+        w[i] = sum;
+    } // for
+
+    return window;
+}
@@ -0,0 +1,75 @@
+#ifndef WINDOWCACHE_H
+#define WINDOWCACHE_H
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "alignedbuffer.h"
+
+class WindowCache {
+    public:
+        enum Type {
+            RECTANGULAR,
+            HAMMING,
+            HANN,
+            // 4 term, -92 dB side lobes
+            BLACKMAN_HARRIS,
+            // parameter is beta, the trade off between main lobe width and side lobes
+            KAISER,
+            // 5 term, for amplitude accuracy between bins
+            FLAT_TOP
+        };
+
+        /**
+         * @brief Gets an n point window. Each window is computed once and shared,
+         * as real coefficients in an aligned buffer, so it is applied as a real scale.
+         * The windows are periodic, i.e. point i of n is at 2*pi*i/n, matching
+         * Filter::hammingWindow.
+         *
+         * @param type Type of window
+         * @param n Number of points
+         * @param param Window parameter, i.e. beta for KAISER, otherwise ignored
+         * @return std::shared_ptr<const AlignedBuffer<float>>
+         */
+        static std::shared_ptr<const AlignedBuffer<float>> get(Type type, int n, double param=0);
+
+        /**
+         * @brief Gets the type of window for its name: "none", "hamm", "hann",
+         * "blackmanharris", "kaiser" or "flattop"
+         *
+         * @param name
+         * @return Type
+         */
+        static Type parseType(const std::string &name);
+
+        /**
+         * @brief Gets the coefficients c of a window that is a sum of cosines,
+         * w[i] = c[0] + c[1] cos(x) + c[2] cos(2x) + ... at x = 2*pi*i/n, or
+         * an empty vector for KAISER, which is not
+         *
+         * @param type Type of window
+         * @return std::vector<double>
+         */
+        static std::vector<double> getCosineTerms(Type type);
+
+        /**
+         * @brief Releases every cached window. Windows still in use stay valid.
+         *
+         */
+        static void clear();
+
+        /**
+         * @brief Kaiser beta used when a window is only given by name
+         */
+        static constexpr double defaultKaiserBeta = 8.6;
+
+    private:
+        static std::shared_ptr<AlignedBuffer<float>> compute(Type type, int n, double param);
+
+        static std::mutex mutex;
+        static std::map<std::pair<std::pair<int, int>, double>, std::shared_ptr<const AlignedBuffer<float>>> windows;
+};
+
+#endif // WINDOWCACHE_H
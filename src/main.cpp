@@ -4,15 +4,59 @@
 #include <iostream>
 #include "fft.h"
 #include "stft.h"
+#include "goertzelbank.h"
+#include "streamingstft.h"
+#include "wavreader.h"
 #include "filter.h"
+#include "peakfinder.h"
 #include "doppler.h"
 #include <cmath>
 #include <complex>
 #include <random>
+#include <stdexcept>
 
 using namespace std;
 
-int main() {
+// streams the first channel of a WAV file through the STFT in chunks, so
+// files of any size are read in constant memory
+int processWav(const char *path, int windowLen, int fftLen, int transmitFreq) {
+    WavReader wav(path);
+    StreamingSTFT stft(windowLen, wav.getSamplingFreq(), fftLen, false, "hamm");
+    PeakFinder peakFinder(stft.getFreqBins(), 1, PeakFinder::GAUSSIAN);
+    Doppler dop(transmitFreq);
+
+    cout << "time - frequency - velocity" << endl;
+    cout << ("---------------") << endl;
+
+    std::vector<Peak> peaks;
+    stft.setCallback([&](const std::complex<float> *spectrum, int bins, float time) {
+        peakFinder.find(spectrum, bins, peaks);
+        if (!peaks.empty()) {
+            float vel;
+            dop.measureProjectileVelocity(&peaks[0].freq, 1, &vel);
+            cout << time << " - " << peaks[0].freq << " - " << vel << endl;
+        } // if
+    });
+
+    std::vector<float> chunk(1 << 16);
+    int count;
+    while ((count = wav.readChannel(&chunk[0], chunk.size())) > 0) {
+        stft.push(&chunk[0], count);
+    } // while
+
+    return 0;
+}
+
+int main(int argc, char *argv[]) {
+    if (argc > 1) {
+        try {
+            return processWav(argv[1], 1024, 256, 10000);
+        } catch (const std::exception &e) {
+            cerr << e.what() << endl;
+            return 1;
+        } // catch
+    } // if
+
     // stft vars
     int windowLen = 1024;
     int samplingFreq = 100000;
@@ -55,24 +99,43 @@ int main() {
 
     // truncates signal to multiple of fftLen
     stft.fitSignal(&conv);
-    
-    cout << "Full STFT" << endl;
-    cout << ("---------------") << endl;
-    stft.computeSTFT(&conv);
-    
+
+    // only the filter passband holds the signal, so its bins alone are
+    // computed by a Goertzel bank when that is cheaper than the full STFT
+    float binWidth = (float) samplingFreq / windowLen;
+    int bandBins = (int) std::ceil((fHigh - fLow) / binWidth) + 1;
+    GoertzelBank bank(windowLen, samplingFreq, fftLen,
+        GoertzelBank::binsAround((fLow + fHigh) / 2, bandBins, windowLen, samplingFreq), "hamm");
+    bool useBank = bank.isCheaperThanFFT();
+
+    std::vector<float> freqBins;
+    std::vector<float> timeBins;
+    if (useBank) {
+        cout << "Goertzel bank STFT" << endl;
+        cout << ("---------------") << endl;
+        bank.computeSTFT(&conv);
+        freqBins = bank.getFreqBins();
+        timeBins = bank.getTimeBins();
+    } else {
+        cout << "Full STFT" << endl;
+        cout << ("---------------") << endl;
+        stft.computeSTFT(&conv);
+        freqBins = stft.getFreqBins();
+        timeBins = stft.getTimeBins();
+    } // else
+
     //std::vector<std::vector<std::complex<float>>> stftResult = stft.getResult();
-    std::vector<std::vector<float>> stftMagResult = stft.getMagResult();
-    std::vector<float> freqBins = stft.getFreqBins();
-    std::vector<float> timeBins = stft.getTimeBins();
+    //Spectrogram<float> stftMagResult = stft.getMagSpectrogram();
 
     //for(int i=0;i<1;i++) { //timeBins.size()
     //    for (int j = 0; j < freqBins.size(); j++) {
-    //        cout << timeBins[i] << " - " << freqBins[j] << " - " << stftMagResult[i][j] << endl;
+    //        cout << timeBins[i] << " - " << freqBins[j] << " - " << stftMagResult(i, j) << endl;
     //    } // for
     //} // for
 
-    // extract the principal component from the STFT
-    std::vector<float> principle = fil.getPrinciple(stftMagResult,freqBins);
+    // extract the principal component from the STFT, between bins
+    PeakFinder peakFinder(freqBins, 1, PeakFinder::GAUSSIAN);
+    std::vector<float> principle = peakFinder.getPrinciple(useBank ? bank.getSpectrogram() : stft.getSpectrogram());
 
     for (int j = 0; j < principle.size(); j++) {
         cout << timeBins[j] << " - " << principle[j] << endl;
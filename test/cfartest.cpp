@@ -0,0 +1,275 @@
+// Checks the Cfar threshold factors, detection of synthetic targets in noise, and tracking of the detections
+
+#include <iostream>
+#include <complex>
+#include <cmath>
+#include <random>
+#include <vector>
+#include "cfar.h"
+#include "doppler.h"
+#include "dopplertracker.h"
+
+using namespace std;
+
+namespace {
+
+const int bins = 2048;
+const float binWidth = 10;
+const int transmitFreq = 10000;
+
+// a frame of unit power exponential (square law detected) noise, with each
+// target cell set to its power
+std::vector<std::complex<float>> noiseFrame(std::default_random_engine &generator,
+    const std::vector<int> &targets=std::vector<int>(), const std::vector<float> &powers=std::vector<float>()) {
+    std::exponential_distribution<float> power(1.0);
+    std::uniform_real_distribution<float> phase(0, 2 * M_PI);
+
+    std::vector<std::complex<float>> spectrum(bins);
+    for (int k = 0; k < bins; k++) {
+        spectrum[k] = std::polar(std::sqrt(power(generator)), phase(generator));
+    } // for
+    for (int i = 0; i < targets.size(); i++) {
+        spectrum[targets[i]] = std::sqrt(powers[i]);
+    } // for
+
+    return spectrum;
+}
+
+bool detected(const std::vector<Detection> &detections, int bin) {
+    for (int i = 0; i < detections.size(); i++) {
+        if (detections[i].bin == bin) {
+            return true;
+        } // if
+    } // for
+
+    return false;
+}
+
+int check(const char *name, bool passed) {
+    if (passed) {
+        return 0;
+    } // if
+
+    cout << "FAIL " << name << endl;
+    return 1;
+}
+
+int checkFactors() {
+    int failures = 0;
+
+    for (int ref : {1, 4, 16, 32}) {
+        for (double pfa : {1e-2, 1e-4, 1e-6}) {
+            std::vector<float> freqBins(bins);
+
+            // cell averaging: n (pfa^(-1/n) - 1) of all n = 2 refCells cells
+            int n = 2 * ref;
+            double expected = n * (std::pow(pfa, -1.0 / n) - 1);
+            Cfar averaging(freqBins, 2, ref, pfa, Cfar::CELL_AVERAGING);
+            failures += check("cell averaging factor",
+                std::fabs(averaging.getThresholdFactor() - expected) <= 1e-9 * expected);
+
+            // ordered statistic: the factor t gives prod_{i<k} (n-i)/(n-i+t) = pfa
+            // for the default rank k, 3/4 of the cells
+            int k = std::max(1, 3 * ref / 2);
+            Cfar ordered(freqBins, 2, ref, pfa, Cfar::ORDERED_STATISTIC);
+            double t = ordered.getThresholdFactor();
+            double rate = 1;
+            for (int i = 0; i < k; i++) {
+                rate *= (n - i) / (n - i + t);
+            } // for
+            failures += check("ordered statistic factor", std::fabs(rate - pfa) <= 1e-9 * pfa);
+        } // for
+    } // for
+
+    return failures;
+}
+
+int checkDetection(std::default_random_engine &generator) {
+    int failures = 0;
+    std::vector<float> freqBins(bins);
+    for (int k = 0; k < bins; k++) {
+        freqBins[k] = k * binWidth;
+    } // for
+
+    Cfar averaging(freqBins, 2, 16, 1e-6, Cfar::CELL_AVERAGING);
+    Cfar ordered(freqBins, 2, 16, 1e-6, Cfar::ORDERED_STATISTIC);
+
+    // a lone target 30 dB above the noise is found by both, at its bin, even at the ends
+    int lone[] = {300, 0, bins - 1};
+    for (int bin : lone) {
+        std::vector<std::complex<float>> frame = noiseFrame(generator, {bin}, {1000});
+        std::vector<Detection> ca;
+        std::vector<Detection> os;
+        averaging.detect(&frame[0], bins, ca);
+        ordered.detect(&frame[0], bins, os);
+        failures += check("cell averaging lone target", detected(ca, bin) && ca.size() == 1);
+        failures += check("ordered statistic lone target", detected(os, bin) && os.size() == 1);
+
+        // the noise estimate is near the unit mean power, so the SNR is near 30 dB
+        for (int i = 0; i < os.size(); i++) {
+            failures += check("detection fields", os[i].frame == 0 && os[i].freq == freqBins[bin]
+                && std::fabs(os[i].power - 1000) <= 1e-3 * 1000 && os[i].snr > 26 && os[i].snr < 32);
+        } // for
+    } // for
+
+    // a 40 dB target in the reference cells of a 20 dB one masks it from
+    // cell averaging, but not from the ordered statistic
+    std::vector<std::complex<float>> frame = noiseFrame(generator, {1000, 1008}, {10000, 100});
+    std::vector<Detection> ca;
+    std::vector<Detection> os;
+    averaging.detect(&frame[0], bins, ca);
+    ordered.detect(&frame[0], bins, os);
+    failures += check("cell averaging strong target", detected(ca, 1000));
+    failures += check("cell averaging masked target", !detected(ca, 1008));
+    failures += check("ordered statistic both targets", detected(os, 1000) && detected(os, 1008) && os.size() == 2);
+
+    // the rate of false alarms in noise alone stays at or below pfa, as only
+    // local maxima are reported
+    Cfar loose(freqBins, 2, 16, 1e-2, Cfar::ORDERED_STATISTIC);
+    int alarms = 0;
+    int frames = 100;
+    for (int f = 0; f < frames; f++) {
+        std::vector<std::complex<float>> noise = noiseFrame(generator);
+        std::vector<Detection> found;
+        loose.detect(&noise[0], bins, found);
+        alarms += found.size();
+    } // for
+    double rate = (double) alarms / (frames * bins);
+    failures += check("false alarm rate", rate > 1e-3 && rate <= 1.2e-2);
+
+    return failures;
+}
+
+int checkTracking(std::default_random_engine &generator) {
+    int failures = 0;
+    std::vector<float> freqBins(bins);
+    for (int k = 0; k < bins; k++) {
+        freqBins[k] = k * binWidth;
+    } // for
+
+    Cfar cfar(freqBins, 2, 16, 1e-6, Cfar::ORDERED_STATISTIC);
+    DopplerTracker tracker(transmitFreq, 50, 3);
+    float dt = 0.01;
+
+    // a receding target falling 20 Hz a frame, an approaching one rising
+    // 10 Hz a frame that is lost for frames 8 to 10, and one that appears
+    // at frame 5 and is gone for good after frame 9
+    double distances[2] = {0, 0};
+    float lastTime[2] = {0, 0};
+    for (int f = 0; f < 20; f++) {
+        std::vector<int> targets;
+        std::vector<float> powers;
+        targets.push_back(900 - 2 * f);
+        powers.push_back(1000);
+        if (f < 8 || f > 10) {
+            targets.push_back(1050 + f);
+            powers.push_back(1000);
+        } // if
+        if (f >= 5 && f <= 9) {
+            targets.push_back(1500);
+            powers.push_back(1000);
+        } // if
+
+        std::vector<std::complex<float>> frame = noiseFrame(generator, targets, powers);
+        std::vector<Detection> detections;
+        cfar.detect(&frame[0], bins, detections, f);
+        failures += check("every target detected", detections.size() == targets.size());
+
+        const std::vector<Track> &tracks = tracker.update(detections, f * dt);
+
+        // the Doppler velocity of each target, integrated from its first frame
+        for (int i = 0; i < 2; i++) {
+            if (i == 1 && f >= 8 && f <= 10) {
+                continue;
+            } // if
+            float freq = freqBins[targets[i]];
+            double velocity = Doppler::speedOfSound * (double) (transmitFreq - freq) / (transmitFreq + freq);
+            if (f > 0) {
+                distances[i] += (f * dt - lastTime[i]) * velocity;
+            } // if
+            lastTime[i] = f * dt;
+        } // for
+
+        if (f == 9) {
+            failures += check("three tracks while all are present or coasting", tracks.size() == 3);
+        } // if
+        if (f == 13) {
+            failures += check("a track dropped after too many misses", tracks.size() == 2);
+        } // if
+    } // for
+
+    const std::vector<Track> &tracks = tracker.getTracks();
+    failures += check("two tracks at the end", tracks.size() == 2);
+    if (tracks.size() == 2) {
+        float freqs[2] = {freqBins[900 - 2 * 19], freqBins[1050 + 19]};
+        int hits[2] = {20, 17};
+        for (int i = 0; i < 2; i++) {
+            const Track &track = tracks[i];
+            double velocity = Doppler::speedOfSound * (double) (transmitFreq - freqs[i]) / (transmitFreq + freqs[i]);
+            failures += check("track kept its id", track.id == i);
+            failures += check("track frequency", track.freq == freqs[i]);
+            failures += check("track hits", track.hits == hits[i] && track.misses == 0);
+            failures += check("track velocity", std::fabs(track.velocity - velocity) <= 1e-3);
+            failures += check("track distance", std::fabs(track.distance - distances[i]) <= 1e-3 * std::fabs(distances[i]));
+        } // for
+    } // if
+
+    return failures;
+}
+
+int checkVelocities() {
+    int failures = 0;
+
+    // three 1 m/s velocity bins about 17 m/s reach two velocities each, and
+    // the mode stays with the bin of 9000 Hz, the first to reach two
+    DopplerTracker tracker(transmitFreq, 200, 3, 1);
+    Doppler doppler(transmitFreq);
+    const float freqs[] = {9000, 9010, 9000, 9100, 9100, 9005};
+    for (int f = 0; f < 6; f++) {
+        tracker.update(std::vector<float>(1, freqs[f]), f * 0.01f);
+    } // for
+
+    const std::vector<Track> &tracks = tracker.getTracks();
+    failures += check("one track", tracks.size() == 1);
+    if (tracks.size() == 1) {
+        float velocities[2];
+        float pair[2] = {9000, freqs[5]};
+        doppler.measureProjectileVelocity(pair, 2, velocities);
+        failures += check("steady velocity is the mode", std::fabs(tracks[0].steadyVelocity - velocities[0]) <= 1e-5);
+        failures += check("tracker and Doppler velocities agree", std::fabs(tracks[0].velocity - velocities[1]) <= 1e-5);
+    } // if
+
+    // the velocities of each frame's detections, including an empty frame
+    std::vector<std::vector<Detection>> detections(3);
+    for (int j = 0; j < 5; j++) {
+        Detection detection = {0, 0, freqs[j], 1, 0};
+        detections[j < 2 ? 0 : 2].push_back(detection);
+    } // for
+    std::vector<std::vector<float>> perFrame = doppler.measureProjectileVelocity(detections);
+    failures += check("velocities per frame", perFrame.size() == 3 && perFrame[0].size() == 2
+        && perFrame[1].empty() && perFrame[2].size() == 3);
+    if (perFrame.size() == 3 && perFrame[0].size() == 2 && perFrame[2].size() == 3) {
+        for (int j = 0; j < 5; j++) {
+            float velocity = j < 2 ? perFrame[0][j] : perFrame[2][j - 2];
+            double expected = Doppler::speedOfSound * (double) (transmitFreq - freqs[j]) / (transmitFreq + freqs[j]);
+            failures += check("velocity of a detection", std::fabs(velocity - expected) <= 1e-3);
+        } // for
+    } // if
+
+    return failures;
+}
+
+} // namespace
+
+int main() {
+    std::default_random_engine generator;
+    int failures = 0;
+
+    failures += checkFactors();
+    failures += checkDetection(generator);
+    failures += checkTracking(generator);
+    failures += checkVelocities();
+
+    cout << (failures == 0 ? "all detections match" : "detections differ") << endl;
+    return failures == 0 ? 0 : 1;
+}
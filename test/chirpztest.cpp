@@ -0,0 +1,78 @@
+// Checks repeated ChirpZ zoom spectra against a direct sum at each frequency
+
+#include <iostream>
+#include <complex>
+#include <cmath>
+#include <random>
+#include <vector>
+#include "chirpz.h"
+
+using namespace std;
+
+namespace {
+
+const double tolerance = 1e-4;
+const int samplingFreq = 48000;
+
+// X(f) = sum_n x[n] e^(-j 2 pi f n / fs), in double precision
+std::vector<std::complex<double>> directSum(const std::vector<std::complex<float>> &input, const std::vector<float> &freqs) {
+    std::vector<std::complex<double>> result(freqs.size());
+    for (int k = 0; k < freqs.size(); k++) {
+        for (int n = 0; n < input.size(); n++) {
+            result[k] += std::complex<double>(input[n]) * std::polar(1.0, -2 * M_PI * freqs[k] * n / samplingFreq);
+        } // for
+    } // for
+
+    return result;
+}
+
+// largest difference, relative to the largest value of the reference
+double relativeError(const std::vector<std::complex<float>> &result, const std::vector<std::complex<double>> &reference) {
+    double err = 0;
+    double scale = 0;
+    for (int k = 0; k < reference.size(); k++) {
+        err = std::max(err, std::abs(std::complex<double>(result[k]) - reference[k]));
+        scale = std::max(scale, std::abs(reference[k]));
+    } // for
+
+    return scale > 0 ? err / scale : err;
+}
+
+int check(int len, int bins, int run, double err) {
+    if (err <= tolerance) {
+        return 0;
+    } // if
+
+    cout << "FAIL len " << len << " bins " << bins << " run " << run << " error " << err << endl;
+    return 1;
+}
+
+} // namespace
+
+int main() {
+    std::default_random_engine generator;
+    std::uniform_real_distribution<float> distribution(-1.0, 1.0);
+    int failures = 0;
+
+    const int sizes[][2] = {{1, 1}, {1, 7}, {16, 1}, {100, 37}, {256, 256}, {1000, 64}, {63, 500}};
+
+    for (const int *size : sizes) {
+        int len = size[0];
+        int bins = size[1];
+        ChirpZ zoom(len, bins, 9000, 11000, samplingFreq);
+
+        // each run must not see the one before it
+        for (int run = 0; run < 3; run++) {
+            std::vector<std::complex<float>> input(len);
+            for (int n = 0; n < len; n++) {
+                input[n] = std::complex<float>(distribution(generator), distribution(generator));
+            } // for
+
+            std::vector<std::complex<float>> output = zoom.execute(input);
+            failures += check(len, bins, run, relativeError(output, directSum(input, zoom.getFreqBins())));
+        } // for
+    } // for
+
+    cout << (failures == 0 ? "all spectra match" : "spectra differ") << endl;
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,127 @@
+// Checks every Convolver method against a direct convolution, across block boundaries
+
+#include <iostream>
+#include <complex>
+#include <cmath>
+#include <random>
+#include <vector>
+#include "convolver.h"
+#include "filter.h"
+
+using namespace std;
+
+namespace {
+
+const double tolerance = 1e-4;
+
+// largest difference, relative to the largest value of the reference
+double relativeError(const std::vector<std::complex<float>> &result, const std::vector<std::complex<float>> &reference) {
+    if (result.size() != reference.size()) {
+        return INFINITY;
+    } // if
+
+    double err = 0;
+    double scale = 0;
+    for (int i = 0; i < reference.size(); i++) {
+        err = std::max(err, (double) std::abs(result[i] - reference[i]));
+        scale = std::max(scale, (double) std::abs(reference[i]));
+    } // for
+
+    return scale > 0 ? err / scale : err;
+}
+
+std::vector<std::complex<float>> randomSignal(int len, std::default_random_engine &generator) {
+    std::uniform_real_distribution<float> distribution(-1.0, 1.0);
+    std::vector<std::complex<float>> signal(len);
+    for (int i = 0; i < len; i++) {
+        signal[i] = std::complex<float>(distribution(generator), distribution(generator));
+    } // for
+
+    return signal;
+}
+
+std::vector<std::complex<float>> directConvolution(const std::vector<std::complex<float>> &seq, const std::vector<std::complex<float>> &fil) {
+    std::vector<std::complex<float>> result(seq.size() + fil.size() - 1);
+    for (int n = 0; n < result.size(); n++) {
+        std::complex<double> sum = 0;
+        for (int i = 0; i < fil.size(); i++) {
+            if (n - i >= 0 && n - i < seq.size()) {
+                sum += std::complex<double>(fil[i]) * std::complex<double>(seq[n - i]);
+            } // if
+        } // for
+        result[n] = std::complex<float>(sum);
+    } // for
+
+    return result;
+}
+
+int check(const char *name, int filLen, int seqLen, double err) {
+    if (err <= tolerance) {
+        return 0;
+    } // if
+
+    cout << "FAIL " << name << " filter " << filLen << " sequence " << seqLen << " error " << err << endl;
+    return 1;
+}
+
+} // namespace
+
+int main() {
+    std::default_random_engine generator;
+    int failures = 0;
+
+    const Convolver::Method methods[] = {Convolver::AUTO, Convolver::DIRECT, Convolver::OVERLAP_ADD, Convolver::OVERLAP_SAVE};
+    const char *names[] = {"AUTO", "DIRECT", "OVERLAP_ADD", "OVERLAP_SAVE"};
+
+    for (int filLen : {1, 2, 5, 16, 17, 31, 100}) {
+        std::vector<std::complex<float>> fil = randomSignal(filLen, generator);
+
+        // AUTO convolves up to directMaxLen taps directly
+        Convolver automatic(fil);
+        Convolver::Method expected = filLen <= Convolver::directMaxLen ? Convolver::DIRECT : Convolver::OVERLAP_SAVE;
+        if (automatic.getMethod() != expected) {
+            cout << "FAIL AUTO picked method " << automatic.getMethod() << " for filter " << filLen << endl;
+            failures++;
+        } // if
+
+        // the smallest block gives the most block boundaries
+        int minFFTLen = 2;
+        while (minFFTLen < 2 * filLen) {
+            minFFTLen *= 2;
+        } // while
+
+        for (int m = 0; m < 4; m++) {
+            for (int fftLen : {0, minFFTLen}) {
+                Convolver convolver(fil, methods[m], fftLen);
+                int step = convolver.getFFTLen() - filLen + 1;
+
+                // shorter than one block, either side of a block boundary and many blocks
+                for (int seqLen : {1, 2, step - 1, step, step + 1, 3 * step + 7, 1000}) {
+                    if (seqLen <= 0) {
+                        continue;
+                    } // if
+
+                    std::vector<std::complex<float>> seq = randomSignal(seqLen, generator);
+                    failures += check(names[m], filLen, seqLen, relativeError(convolver.convolve(seq), directConvolution(seq, fil)));
+                } // for
+            } // for
+        } // for
+    } // for
+
+    // both Filter entry points give the len1 + len2 output, whose last value is zero
+    Filter filter;
+    std::vector<std::complex<float>> seq = randomSignal(500, generator);
+    for (int filLen : {8, 64}) {
+        std::vector<std::complex<float>> fil = randomSignal(filLen, generator);
+        std::vector<std::complex<float>> reference = directConvolution(seq, fil);
+        reference.push_back(0);
+
+        failures += check("Filter::applyFilterByConv", filLen, seq.size(),
+            relativeError(filter.applyFilterByConv(seq, fil, seq.size(), fil.size()), reference));
+        failures += check("Filter::applyFilterByConv with a Convolver", filLen, seq.size(),
+            relativeError(filter.applyFilterByConv(seq, seq.size(), Convolver(fil)), reference));
+    } // for
+
+    cout << (failures == 0 ? "all methods match" : "methods differ") << endl;
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,139 @@
+// Checks every FFTPlan engine against the radix-2 output at every SIMD level
+
+#include <iostream>
+#include <complex>
+#include <cmath>
+#include <random>
+#include <vector>
+#include "fftplan.h"
+#include "simd.h"
+
+using namespace std;
+
+namespace {
+
+const double tolerance = 1e-4;
+
+// largest difference, relative to the largest value of the reference
+double relativeError(const std::vector<std::complex<float>> &result, const std::vector<std::complex<float>> &reference) {
+    double err = 0;
+    double scale = 0;
+    for (int i = 0; i < reference.size(); i++) {
+        err = std::max(err, (double) std::abs(result[i] - reference[i]));
+        scale = std::max(scale, (double) std::abs(reference[i]));
+    } // for
+
+    return scale > 0 ? err / scale : err;
+}
+
+std::vector<std::complex<float>> randomSignal(int len, std::default_random_engine &generator) {
+    std::uniform_real_distribution<float> distribution(-1.0, 1.0);
+    std::vector<std::complex<float>> signal(len);
+    for (int i = 0; i < len; i++) {
+        signal[i] = std::complex<float>(distribution(generator), distribution(generator));
+    } // for
+
+    return signal;
+}
+
+std::vector<std::complex<float>> transform(int len, FFTPlan::Engine engine, const std::vector<std::complex<float>> &signal) {
+    FFTPlan plan(len, engine);
+    std::vector<std::complex<float>> result(signal);
+    plan.execute(&result[0]);
+
+    return result;
+}
+
+std::vector<std::complex<float>> directDft(const std::vector<std::complex<float>> &signal) {
+    int len = signal.size();
+    std::vector<std::complex<float>> result(len);
+    for (int k = 0; k < len; k++) {
+        std::complex<double> sum = 0;
+        for (int n = 0; n < len; n++) {
+            sum += std::complex<double>(signal[n]) * std::polar(1.0, -2 * M_PI * (((long long) k * n) % len) / len);
+        } // for
+        result[k] = std::complex<float>(sum);
+    } // for
+
+    return result;
+}
+
+int check(const char *name, int len, Simd::Level level, double err) {
+    if (err <= tolerance) {
+        return 0;
+    } // if
+
+    cout << "FAIL " << name << " len " << len << " level " << level << " error " << err << endl;
+    return 1;
+}
+
+} // namespace
+
+int main() {
+    std::default_random_engine generator;
+    int failures = 0;
+
+    const FFTPlan::Engine engines[] = {FFTPlan::RADIX_4, FFTPlan::SPLIT_RADIX, FFTPlan::MIXED_RADIX, FFTPlan::BLUESTEIN};
+    const char *names[] = {"RADIX_4", "SPLIT_RADIX", "MIXED_RADIX", "BLUESTEIN"};
+    const int powerOfTwoLens[] = {1, 2, 4, 8, 16, 32, 64, 128, 256, 512, 1024, 4096};
+    const int smoothLens[] = {3, 6, 12, 15, 49, 100, 360, 1000};
+    const int primeLens[] = {11, 97, 257};
+
+    for (int l = Simd::SCALAR; l <= Simd::AVX512; l++) {
+        Simd::Level level = (Simd::Level) l;
+        Simd::setLevel(level);
+
+        for (int len : powerOfTwoLens) {
+            std::vector<std::complex<float>> signal = randomSignal(len, generator);
+            std::vector<std::complex<float>> reference = transform(len, FFTPlan::RADIX_2, signal);
+
+            failures += check("RADIX_2 against a direct DFT", len, level, relativeError(reference, directDft(signal)));
+            for (int e = 0; e < 4; e++) {
+                failures += check(names[e], len, level, relativeError(transform(len, engines[e], signal), reference));
+            } // for
+
+            // batched frames must match single frames
+            FFTPlan plan(len, FFTPlan::AUTO);
+            std::vector<std::complex<float>> frames(signal);
+            frames.insert(frames.end(), signal.begin(), signal.end());
+            plan.executeBatch(&frames[0], 2, len);
+            std::vector<std::complex<float>> second(frames.begin() + len, frames.end());
+            failures += check("AUTO batch", len, level, relativeError(second, reference));
+        } // for
+
+        for (int len : smoothLens) {
+            std::vector<std::complex<float>> signal = randomSignal(len, generator);
+            std::vector<std::complex<float>> reference = directDft(signal);
+
+            failures += check("MIXED_RADIX", len, level, relativeError(transform(len, FFTPlan::MIXED_RADIX, signal), reference));
+            failures += check("BLUESTEIN", len, level, relativeError(transform(len, FFTPlan::BLUESTEIN, signal), reference));
+        } // for
+
+        for (int len : primeLens) {
+            std::vector<std::complex<float>> signal = randomSignal(len, generator);
+            failures += check("BLUESTEIN", len, level, relativeError(transform(len, FFTPlan::BLUESTEIN, signal), directDft(signal)));
+        } // for
+
+        // real transforms, including the one point half length plan of len 2
+        for (int len : {2, 4, 16, 256, 1024}) {
+            std::vector<std::complex<float>> signal = randomSignal(len, generator);
+            std::vector<float> real(len);
+            for (int i = 0; i < len; i++) {
+                real[i] = signal[i].real();
+                signal[i] = std::complex<float>(signal[i].real(), 0);
+            } // for
+            std::vector<std::complex<float>> reference = directDft(signal);
+            reference.resize(len/2 + 1);
+
+            for (int e = 0; e < 4; e++) {
+                RealFFTPlan plan(len, engines[e]);
+                std::vector<std::complex<float>> bins(plan.getBinCount());
+                plan.execute(&real[0], &bins[0]);
+                failures += check(names[e], len, level, relativeError(bins, reference));
+            } // for
+        } // for
+    } // for
+
+    cout << (failures == 0 ? "all engines match" : "engines differ") << endl;
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,150 @@
+// Checks streamed FirFilter output, in chunks of every size, against a direct convolution
+
+#include <iostream>
+#include <complex>
+#include <cmath>
+#include <random>
+#include <vector>
+#include "firfilter.h"
+
+using namespace std;
+
+namespace {
+
+const double tolerance = 1e-5;
+
+float randomValue(std::default_random_engine &generator) {
+    return std::uniform_real_distribution<float>(-1.0, 1.0)(generator);
+}
+
+void randomize(std::vector<float> &values, std::default_random_engine &generator) {
+    for (int i = 0; i < values.size(); i++) {
+        values[i] = randomValue(generator);
+    } // for
+}
+
+void randomize(std::vector<std::complex<float>> &values, std::default_random_engine &generator) {
+    for (int i = 0; i < values.size(); i++) {
+        values[i] = std::complex<float>(randomValue(generator), randomValue(generator));
+    } // for
+}
+
+std::vector<float> randomTaps(int len, bool symmetric, std::default_random_engine &generator) {
+    std::vector<float> taps(len);
+    randomize(taps, generator);
+    if (symmetric) {
+        for (int i = 0; i < len/2; i++) {
+            taps[len - 1 - i] = taps[i];
+        } // for
+    } else if (len > 1) {
+        // make sure random taps are not symmetric by chance
+        taps[len - 1] = taps[0] + 1;
+    } // else
+
+    return taps;
+}
+
+void narrow(std::complex<double> value, float &out) {
+    out = value.real();
+}
+
+void narrow(std::complex<double> value, std::complex<float> &out) {
+    out = std::complex<float>(value);
+}
+
+// output[n] = sum_k taps[k] * input[n - k], with zeros before the input
+template <typename T>
+std::vector<T> directConvolution(const std::vector<T> &input, const std::vector<float> &taps) {
+    std::vector<T> result(input.size());
+    for (int n = 0; n < input.size(); n++) {
+        std::complex<double> sum = 0;
+        for (int k = 0; k < taps.size() && k <= n; k++) {
+            sum += (double) taps[k] * std::complex<double>(input[n - k]);
+        } // for
+        narrow(sum, result[n]);
+    } // for
+
+    return result;
+}
+
+template <typename T>
+double relativeError(const std::vector<T> &result, const std::vector<T> &reference) {
+    double err = 0;
+    double scale = 0;
+    for (int i = 0; i < reference.size(); i++) {
+        err = std::max(err, (double) std::abs(result[i] - reference[i]));
+        scale = std::max(scale, (double) std::abs(reference[i]));
+    } // for
+
+    return scale > 0 ? err / scale : err;
+}
+
+int check(const char *type, const char *name, int len, int chunk, double err) {
+    if (err <= tolerance) {
+        return 0;
+    } // if
+
+    cout << "FAIL " << type << " " << name << " taps " << len << " chunk " << chunk << " error " << err << endl;
+    return 1;
+}
+
+template <typename T>
+int checkFilters(const char *type, std::default_random_engine &generator) {
+    int failures = 0;
+
+    std::vector<T> input(2000);
+    randomize(input, generator);
+
+    for (int len : {1, 2, 3, 8, 31, 64, 101, 300}) {
+        for (bool symmetric : {true, false}) {
+            std::vector<float> taps = randomTaps(len, symmetric, generator);
+            std::vector<T> reference = directConvolution(input, taps);
+            const char *name = symmetric ? (len % 2 ? "odd symmetric" : "even symmetric") : "not symmetric";
+
+            FirFilter<T> filter(taps);
+            if (filter.isSymmetric() != (symmetric || len == 1)) {
+                cout << "FAIL " << type << " " << name << " taps " << len << " symmetry not detected" << endl;
+                failures++;
+            } // if
+
+            // chunks smaller than, equal to and larger than the filter and the internal block
+            for (int chunk : {1, 3, len, 255, 256, 257, 1000, 2000}) {
+                filter.reset();
+                std::vector<T> output(input.size());
+                for (int start = 0; start < input.size(); start += chunk) {
+                    int count = std::min(chunk, (int) input.size() - start);
+                    filter.process(&input[start], &output[start], count);
+                } // for
+                failures += check(type, name, len, chunk, relativeError(output, reference));
+            } // for
+
+            // in place, and one sample at a time
+            filter.reset();
+            std::vector<T> samples(input);
+            filter.process(&samples[0], 700);
+            filter.process(&samples[700], samples.size() - 700);
+            failures += check(type, name, len, -1, relativeError(samples, reference));
+
+            filter.reset();
+            for (int n = 0; n < input.size(); n++) {
+                samples[n] = filter.process(input[n]);
+            } // for
+            failures += check(type, name, len, 0, relativeError(samples, reference));
+        } // for
+    } // for
+
+    return failures;
+}
+
+} // namespace
+
+int main() {
+    std::default_random_engine generator;
+    int failures = 0;
+
+    failures += checkFilters<float>("float", generator);
+    failures += checkFilters<std::complex<float>>("complex", generator);
+
+    cout << (failures == 0 ? "all filters match" : "filters differ") << endl;
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,134 @@
+// Checks GoertzelBank bins against the same bins of the full STFT, for every window and overlap
+
+#include <iostream>
+#include <complex>
+#include <cmath>
+#include <random>
+#include <string>
+#include <vector>
+#include "goertzelbank.h"
+#include "stft.h"
+
+using namespace std;
+
+namespace {
+
+const double tolerance = 1e-4;
+const int samplingFreq = 8000;
+
+// largest difference of the bank from the same bins of the STFT, relative to
+// the largest value of those bins
+double relativeError(const Spectrogram<std::complex<float>> &bank, const Spectrogram<std::complex<float>> &full, const std::vector<int> &bins) {
+    if (bank.getFrameCount() != full.getFrameCount() || bank.getBinCount() != bins.size()) {
+        return INFINITY;
+    } // if
+
+    double err = 0;
+    double scale = 0;
+    for (int f = 0; f < full.getFrameCount(); f++) {
+        for (int k = 0; k < bins.size(); k++) {
+            err = std::max(err, (double) std::abs(bank(f, k) - full(f, bins[k])));
+            scale = std::max(scale, (double) std::abs(full(f, bins[k])));
+        } // for
+    } // for
+
+    return scale > 0 ? err / scale : err;
+}
+
+int check(const char *type, const std::string &window, int windowLen, int fftLen, int hopLen, double err) {
+    if (err <= tolerance) {
+        return 0;
+    } // if
+
+    cout << "FAIL " << type << " " << window << " windowLen " << windowLen << " fftLen " << fftLen
+        << " hop " << hopLen << " error " << err << endl;
+    return 1;
+}
+
+template <typename T>
+void randomize(std::vector<T> &signal, std::default_random_engine &generator);
+
+template <>
+void randomize(std::vector<float> &signal, std::default_random_engine &generator) {
+    std::uniform_real_distribution<float> distribution(-1.0, 1.0);
+    for (int i = 0; i < signal.size(); i++) {
+        signal[i] = distribution(generator);
+    } // for
+}
+
+template <>
+void randomize(std::vector<std::complex<float>> &signal, std::default_random_engine &generator) {
+    std::uniform_real_distribution<float> distribution(-1.0, 1.0);
+    for (int i = 0; i < signal.size(); i++) {
+        signal[i] = std::complex<float>(distribution(generator), distribution(generator));
+    } // for
+}
+
+template <typename T>
+int checkWindows(const char *type, std::default_random_engine &generator) {
+    int failures = 0;
+
+    // a tone at the carrier, so the checked bins are not all noise
+    std::vector<T> signal(3000);
+    randomize(signal, generator);
+    for (int i = 0; i < signal.size(); i++) {
+        signal[i] += T(4 * std::cos(2 * M_PI * 1000.0 * i / samplingFreq));
+    } // for
+
+    const int lengths[][2] = {{128, 128}, {256, 128}, {512, 100}};
+
+    for (const std::string window : {"none", "hamm", "hann", "blackmanharris", "flattop", "kaiser"}) {
+        for (const int *length : lengths) {
+            int windowLen = length[0];
+            int fftLen = length[1];
+            std::vector<int> bins = GoertzelBank::binsAround(1000, 5, windowLen, samplingFreq);
+            bins.push_back(0);
+            bins.push_back(windowLen - 1);
+
+            // no overlap, half overlap, and hops short enough to slide
+            for (int hopLen : {fftLen, fftLen / 2, 9, 1}) {
+                STFT stft(windowLen, samplingFreq, fftLen, true, window, hopLen);
+                std::vector<T> copy(signal);
+                stft.computeSTFT(&copy);
+
+                GoertzelBank bank(windowLen, samplingFreq, fftLen, bins, window, hopLen);
+                bank.computeSTFT(&copy);
+
+                failures += check(type, window, windowLen, fftLen, hopLen,
+                    relativeError(bank.getSpectrogram(), stft.getSpectrogram(), bins));
+
+                if (bank.getTimeBins() != stft.getTimeBins()) {
+                    cout << "FAIL " << type << " " << window << " time bins differ" << endl;
+                    failures++;
+                } // if
+            } // for
+        } // for
+    } // for
+
+    return failures;
+}
+
+} // namespace
+
+int main() {
+    std::default_random_engine generator;
+    int failures = 0;
+
+    failures += checkWindows<float>("real", generator);
+    failures += checkWindows<std::complex<float>>("complex", generator);
+
+    // a handful of bins is cheaper than a 1024 point FFT, every bin is not
+    GoertzelBank few(1024, samplingFreq, 256, GoertzelBank::binsAround(1000, 4, 1024, samplingFreq), "hann", 16);
+    std::vector<int> all(1024);
+    for (int k = 0; k < all.size(); k++) {
+        all[k] = k;
+    } // for
+    GoertzelBank every(1024, samplingFreq, 256, all, "hann", 16);
+    if (!few.isCheaperThanFFT() || every.isCheaperThanFFT()) {
+        cout << "FAIL cost comparison with the FFT" << endl;
+        failures++;
+    } // if
+
+    cout << (failures == 0 ? "all bins match" : "bins differ") << endl;
+    return failures == 0 ? 0 : 1;
+}
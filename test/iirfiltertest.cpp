@@ -0,0 +1,138 @@
+// Checks the impulse response of IIR band-pass cascades at every SIMD level against double precision
+
+#include <iostream>
+#include <complex>
+#include <cmath>
+#include <vector>
+#include "iirfilter.h"
+#include "simd.h"
+
+using namespace std;
+
+namespace {
+
+const double tolerance = 1e-4;
+const int responseLen = 2000;
+const int fs = 8000;
+
+// impulse response of the cascade, in direct form I and double precision
+std::vector<double> impulseResponse(const std::vector<Biquad> &sections) {
+    std::vector<double> x(responseLen, 0);
+    x[0] = 1;
+
+    for (int s = 0; s < sections.size(); s++) {
+        const Biquad &c = sections[s];
+        std::vector<double> y(responseLen);
+        for (int n = 0; n < responseLen; n++) {
+            double v = (double) c.b0 * x[n];
+            if (n >= 1) {
+                v += (double) c.b1 * x[n - 1] - (double) c.a1 * y[n - 1];
+            } // if
+            if (n >= 2) {
+                v += (double) c.b2 * x[n - 2] - (double) c.a2 * y[n - 2];
+            } // if
+            y[n] = v;
+        } // for
+        x.swap(y);
+    } // for
+
+    return x;
+}
+
+// gain of the cascade at freq (Hz)
+double gain(const std::vector<Biquad> &sections, double freq) {
+    std::complex<double> zi = std::polar(1.0, -2 * M_PI * freq / fs);
+    std::complex<double> h = 1;
+    for (int s = 0; s < sections.size(); s++) {
+        const Biquad &c = sections[s];
+        h *= ((double) c.b0 + (double) c.b1 * zi + (double) c.b2 * zi * zi) /
+            (1.0 + (double) c.a1 * zi + (double) c.a2 * zi * zi);
+    } // for
+
+    return std::abs(h);
+}
+
+// largest difference of channel from the reference, relative to the largest value of the reference
+double relativeError(const std::vector<float> &samples, int channels, int channel, const std::vector<double> &reference) {
+    double err = 0;
+    double scale = 0;
+    for (int n = 0; n < reference.size(); n++) {
+        err = std::max(err, std::fabs(samples[n * channels + channel] - reference[n]));
+        scale = std::max(scale, std::fabs(reference[n]));
+    } // for
+
+    return err / scale;
+}
+
+int check(const char *name, int order, int channels, Simd::Level level, double err, double limit=tolerance) {
+    if (err <= limit) {
+        return 0;
+    } // if
+
+    cout << "FAIL " << name << " order " << order << " channels " << channels << " level " << level << " error " << err << endl;
+    return 1;
+}
+
+} // namespace
+
+int main() {
+    int failures = 0;
+
+    for (int order : {1, 2, 3, 4, 6}) {
+        std::vector<Biquad> designs[] = {
+            IirFilter::butterworthBandPass(order, 900, 1100, fs),
+            IirFilter::chebyshevBandPass(order, 1, 900, 1100, fs)
+        };
+        const char *names[] = {"Butterworth", "Chebyshev"};
+
+        for (int d = 0; d < 2; d++) {
+            const std::vector<Biquad> &sections = designs[d];
+            std::vector<double> reference = impulseResponse(sections);
+
+            // the Butterworth gain is 1 at the centre, and the Chebyshev
+            // passband peaks at 1, so neither may pass more than 1 there
+            double centre = gain(sections, std::sqrt(900.0 * 1100.0));
+            if (d == 0) {
+                failures += check("Butterworth centre gain", order, 1, Simd::SCALAR, std::fabs(centre - 1), 1e-3);
+            } else {
+                failures += check("Chebyshev centre gain", order, 1, Simd::SCALAR, centre - 1, 1e-3);
+            } // else
+
+            // one channel at a time, in two blocks
+            IirFilter single(sections);
+            std::vector<float> samples(responseLen, 0);
+            samples[0] = 1;
+            single.process(&samples[0], 700);
+            single.process(&samples[700], responseLen - 700);
+            failures += check(names[d], order, 1, Simd::SCALAR, relativeError(samples, 1, 0, reference));
+
+            // full registers of every width, with a tail of channels behind them
+            for (int l = Simd::SCALAR; l <= Simd::AVX512; l++) {
+                Simd::Level level = (Simd::Level) l;
+                Simd::setLevel(level);
+
+                for (int channels : {1, 3, 4, 8, 16, 21, 35}) {
+                    IirFilter filter(sections, channels);
+
+                    // an impulse in every channel, each scaled differently
+                    std::vector<float> interleaved(responseLen * channels, 0);
+                    for (int c = 0; c < channels; c++) {
+                        interleaved[c] = c + 1;
+                    } // for
+                    filter.processInterleaved(&interleaved[0], 300);
+                    filter.processInterleaved(&interleaved[300 * channels], responseLen - 300);
+
+                    for (int c = 0; c < channels; c++) {
+                        for (int n = 0; n < responseLen; n++) {
+                            interleaved[n * channels + c] /= c + 1;
+                        } // for
+                        failures += check(names[d], order, channels, level, relativeError(interleaved, channels, c, reference));
+                    } // for
+                } // for
+            } // for
+        } // for
+    } // for
+
+    cout << (failures == 0 ? "all cascades match" : "cascades differ") << endl;
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,119 @@
+// Checks the sub-bin interpolation of PeakFinder on tones between bins with a known offset
+
+#include <iostream>
+#include <complex>
+#include <cmath>
+#include <memory>
+#include <vector>
+#include "filter.h"
+#include "peakfinder.h"
+#include "windowcache.h"
+
+using namespace std;
+
+namespace {
+
+const int len = 256;
+const int samplingFreq = 25600;
+const int toneBin = 40;
+
+// windowed spectrum of a complex tone toneBin + offset bins from DC
+std::vector<std::complex<float>> toneSpectrum(double offset, WindowCache::Type window) {
+    std::shared_ptr<const AlignedBuffer<float>> w = WindowCache::get(window, len);
+    std::vector<std::complex<double>> tone(len);
+    for (int n = 0; n < len; n++) {
+        tone[n] = (double) (*w)[n] * std::polar(1.0, 2 * M_PI * (toneBin + offset) * n / len);
+    } // for
+
+    std::vector<std::complex<float>> spectrum(len);
+    for (int k = 0; k < len; k++) {
+        std::complex<double> sum = 0;
+        for (int n = 0; n < len; n++) {
+            sum += tone[n] * std::polar(1.0, -2 * M_PI * ((long long) k * n % len) / len);
+        } // for
+        spectrum[k] = std::complex<float>(sum);
+    } // for
+
+    return spectrum;
+}
+
+int check(const char *name, const char *window, double offset, double err, double limit) {
+    if (err <= limit) {
+        return 0;
+    } // if
+
+    cout << "FAIL " << name << " " << window << " offset " << offset << " error " << err << " bins" << endl;
+    return 1;
+}
+
+} // namespace
+
+int main() {
+    int failures = 0;
+
+    std::vector<float> freqBins(len);
+    for (int k = 0; k < len; k++) {
+        freqBins[k] = k * ((float) samplingFreq / len);
+    } // for
+    float binWidth = freqBins[1];
+
+    // each interpolator on the window it suits, with the error it is allowed in bins
+    struct Case {
+        const char *name;
+        PeakFinder::Interpolation interpolation;
+        const char *windowName;
+        WindowCache::Type window;
+        double limit;
+    };
+    const Case cases[] = {
+        {"NONE", PeakFinder::NONE, "none", WindowCache::RECTANGULAR, 0.5},
+        {"PARABOLIC", PeakFinder::PARABOLIC, "hann", WindowCache::HANN, 0.06},
+        {"PARABOLIC", PeakFinder::PARABOLIC, "hamm", WindowCache::HAMMING, 0.08},
+        {"GAUSSIAN", PeakFinder::GAUSSIAN, "hann", WindowCache::HANN, 0.02},
+        {"GAUSSIAN", PeakFinder::GAUSSIAN, "hamm", WindowCache::HAMMING, 0.02},
+        {"QUINN", PeakFinder::QUINN, "none", WindowCache::RECTANGULAR, 0.001}
+    };
+
+    for (const Case &c : cases) {
+        PeakFinder finder(freqBins, 1, c.interpolation);
+
+        for (double offset : {-0.45, -0.3, -0.1, 0.0, 0.05, 0.25, 0.4, 0.49}) {
+            std::vector<std::complex<float>> spectrum = toneSpectrum(offset, c.window);
+            std::vector<Peak> peaks;
+            finder.find(&spectrum[0], len, peaks);
+
+            if (peaks.empty()) {
+                cout << "FAIL " << c.name << " " << c.windowName << " offset " << offset << " no peak" << endl;
+                failures++;
+                continue;
+            } // if
+
+            // the tone is in the nearest bin, and the offset recovered between bins
+            double estimate = peaks[0].bin + peaks[0].offset;
+            failures += check(c.name, c.windowName, offset, std::fabs(estimate - (toneBin + offset)), c.limit);
+            failures += check(c.name, c.windowName, offset,
+                std::fabs(peaks[0].freq / binWidth - estimate), 1e-3);
+        } // for
+    } // for
+
+    // Filter::getPrinciple of a complex spectrogram is the uninterpolated peak
+    Spectrogram<std::complex<float>> spectrogram(3, len);
+    const double offsets[] = {-0.3, 0.0, 0.4};
+    for (int f = 0; f < 3; f++) {
+        std::vector<std::complex<float>> spectrum = toneSpectrum(offsets[f], WindowCache::HANN);
+        for (int k = 0; k < len; k++) {
+            spectrogram(f, k) = spectrum[k];
+        } // for
+    } // for
+
+    Filter filter;
+    std::vector<float> principle = filter.getPrinciple(spectrogram, freqBins);
+    if (principle != PeakFinder(freqBins, 1, PeakFinder::NONE).getPrinciple(spectrogram)
+        || principle[0] != freqBins[toneBin] || principle[2] != freqBins[toneBin]) {
+        cout << "FAIL Filter::getPrinciple differs from PeakFinder" << endl;
+        failures++;
+    } // if
+
+    cout << (failures == 0 ? "all peaks match" : "peaks differ") << endl;
+    return failures == 0 ? 0 : 1;
+}
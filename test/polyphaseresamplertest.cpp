@@ -0,0 +1,185 @@
+// Checks streamed PolyphaseResampler output against upsampling, filtering and decimating
+
+#include <iostream>
+#include <complex>
+#include <cmath>
+#include <cstdlib>
+#include <random>
+#include <vector>
+#include "filter.h"
+#include "filterdesigncache.h"
+#include "polyphaseresampler.h"
+
+using namespace std;
+
+namespace {
+
+const double tolerance = 1e-5;
+
+float randomValue(std::default_random_engine &generator) {
+    return std::uniform_real_distribution<float>(-1.0, 1.0)(generator);
+}
+
+// zero stuffs up - 1 samples after each input, scaled by up to keep the gain,
+// filters with Filter::applyFilterByConv and keeps every down-th output
+std::vector<double> reference(const std::vector<double> &input, int up, int down, const std::vector<float> &coeffs) {
+    std::vector<double> upsampled(input.size() * up, 0);
+    for (int n = 0; n < input.size(); n++) {
+        upsampled[n * up] = input[n] * up;
+    } // for
+
+    std::vector<double> taps(coeffs.begin(), coeffs.end());
+    Filter filter;
+    double *filtered = filter.applyFilterByConv(&upsampled[0], &taps[0], upsampled.size(), taps.size());
+
+    std::vector<double> result;
+    for (int t = 0; t < upsampled.size(); t += down) {
+        result.push_back(filtered[t]);
+    } // for
+    free(filtered);
+
+    return result;
+}
+
+std::vector<std::complex<float>> reference(const std::vector<std::complex<float>> &input, int up, int down, const std::vector<float> &coeffs) {
+    std::vector<double> re(input.size());
+    std::vector<double> im(input.size());
+    for (int n = 0; n < input.size(); n++) {
+        re[n] = input[n].real();
+        im[n] = input[n].imag();
+    } // for
+
+    re = reference(re, up, down, coeffs);
+    im = reference(im, up, down, coeffs);
+
+    std::vector<std::complex<float>> result(re.size());
+    for (int n = 0; n < result.size(); n++) {
+        result[n] = std::complex<float>(re[n], im[n]);
+    } // for
+
+    return result;
+}
+
+std::vector<float> reference(const std::vector<float> &input, int up, int down, const std::vector<float> &coeffs) {
+    std::vector<double> result = reference(std::vector<double>(input.begin(), input.end()), up, down, coeffs);
+    return std::vector<float>(result.begin(), result.end());
+}
+
+void randomize(std::vector<float> &values, std::default_random_engine &generator) {
+    for (int i = 0; i < values.size(); i++) {
+        values[i] = randomValue(generator);
+    } // for
+}
+
+void randomize(std::vector<std::complex<float>> &values, std::default_random_engine &generator) {
+    for (int i = 0; i < values.size(); i++) {
+        values[i] = std::complex<float>(randomValue(generator), randomValue(generator));
+    } // for
+}
+
+template <typename T>
+double relativeError(const std::vector<T> &result, const std::vector<T> &reference) {
+    if (result.size() != reference.size()) {
+        return INFINITY;
+    } // if
+
+    double err = 0;
+    double scale = 0;
+    for (int i = 0; i < reference.size(); i++) {
+        err = std::max(err, (double) std::abs(result[i] - reference[i]));
+        scale = std::max(scale, (double) std::abs(reference[i]));
+    } // for
+
+    return scale > 0 ? err / scale : err;
+}
+
+template <typename T>
+std::vector<T> resample(PolyphaseResampler<T> &resampler, const std::vector<T> &input, int chunk) {
+    std::vector<T> output;
+    for (int start = 0; start < input.size(); start += chunk) {
+        int count = std::min(chunk, (int) input.size() - start);
+        std::vector<T> block(resampler.getMaxOutputCount(count));
+        block.resize(resampler.process(&input[start], count, &block[0]));
+        output.insert(output.end(), block.begin(), block.end());
+    } // for
+
+    return output;
+}
+
+int check(const char *type, const char *name, int up, int down, int chunk, double err) {
+    if (err <= tolerance) {
+        return 0;
+    } // if
+
+    cout << "FAIL " << type << " " << name << " " << up << "/" << down << " chunk " << chunk << " error " << err << endl;
+    return 1;
+}
+
+template <typename T>
+int checkRatios(const char *type, std::default_random_engine &generator) {
+    int failures = 0;
+
+    std::vector<T> input(3000);
+    randomize(input, generator);
+
+    // including ratios with common factors, which the given coefficients keep
+    const int ratios[][2] = {{1, 1}, {1, 3}, {3, 1}, {2, 3}, {3, 2}, {2, 2}, {3, 3}, {4, 6}, {6, 4}, {10, 4}, {5, 7}};
+
+    for (const int *ratio : ratios) {
+        int up = ratio[0];
+        int down = ratio[1];
+
+        for (int len : {1, 24, 37}) {
+            std::vector<float> coeffs(len);
+            randomize(coeffs, generator);
+            std::vector<T> expected = reference(input, up, down, coeffs);
+
+            PolyphaseResampler<T> resampler(up, down, coeffs);
+            if (resampler.getUp() != up || resampler.getDown() != down) {
+                cout << "FAIL " << type << " given coefficients changed " << up << "/" << down << endl;
+                failures++;
+            } // if
+
+            // chunks either side of the internal block, and the whole input
+            for (int chunk : {1, 7, 1023, 1024, 1025, 3000}) {
+                resampler.reset();
+                failures += check(type, "given coefficients", up, down, chunk, relativeError(resample(resampler, input, chunk), expected));
+            } // for
+        } // for
+
+        // the Kaiser-Bessel design reduces the ratio, then matches its coefficients given directly
+        int common = up;
+        for (int b = down; b != 0; ) {
+            int t = common % b;
+            common = b;
+            b = t;
+        } // for
+        int rate = std::max(up, down) / common;
+        int len = std::max(16 * (up / common) + 1, 2 * rate + 1) | 1;
+        std::shared_ptr<const std::vector<double>> design = FilterDesignCache::kaiserBessel(len, 60, 1, 0, 2 * rate);
+        std::vector<float> coeffs(design->begin(), design->end());
+
+        PolyphaseResampler<T> designed(up, down);
+        if (designed.getUp() != up / common || designed.getDown() != down / common) {
+            cout << "FAIL " << type << " Kaiser-Bessel design did not reduce " << up << "/" << down << endl;
+            failures++;
+        } // if
+        failures += check(type, "Kaiser-Bessel", up, down, 1000,
+            relativeError(resample(designed, input, 1000), reference(input, up / common, down / common, coeffs)));
+    } // for
+
+    return failures;
+}
+
+} // namespace
+
+int main() {
+    std::default_random_engine generator;
+    int failures = 0;
+
+    failures += checkRatios<float>("float", generator);
+    failures += checkRatios<std::complex<float>>("complex", generator);
+
+    cout << (failures == 0 ? "all ratios match" : "ratios differ") << endl;
+    return failures == 0 ? 0 : 1;
+}
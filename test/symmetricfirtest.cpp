@@ -0,0 +1,105 @@
+// Checks the symmetric FIR kernel at every SIMD level against the scalar kernel
+
+#include <iostream>
+#include <complex>
+#include <cmath>
+#include <random>
+#include <vector>
+#include "simd.h"
+
+using namespace std;
+
+namespace {
+
+const double tolerance = 1e-5;
+
+std::vector<float> randomValues(int len, std::default_random_engine &generator) {
+    std::uniform_real_distribution<float> distribution(-1.0, 1.0);
+    std::vector<float> values(len);
+    for (int i = 0; i < len; i++) {
+        values[i] = distribution(generator);
+    } // for
+
+    return values;
+}
+
+// largest difference, relative to the largest value of the reference
+double relativeError(const float *result, const float *reference, int count) {
+    double err = 0;
+    double scale = 0;
+    for (int i = 0; i < count; i++) {
+        err = std::max(err, (double) std::fabs(result[i] - reference[i]));
+        scale = std::max(scale, (double) std::fabs(reference[i]));
+    } // for
+
+    return scale > 0 ? err / scale : err;
+}
+
+// output[n] = sum_k taps[k] * input[n + k], with the taps mirrored
+std::vector<float> directFir(const std::vector<float> &input, const std::vector<float> &taps, int len, int count) {
+    std::vector<float> result(count);
+    for (int n = 0; n < count; n++) {
+        double sum = 0;
+        for (int k = 0; k < len; k++) {
+            sum += (double) taps[k < len - 1 - k ? k : len - 1 - k] * input[n + k];
+        } // for
+        result[n] = sum;
+    } // for
+
+    return result;
+}
+
+int check(const char *name, int len, int count, Simd::Level level, double err) {
+    if (err <= tolerance) {
+        return 0;
+    } // if
+
+    cout << "FAIL " << name << " taps " << len << " outputs " << count << " level " << level << " error " << err << endl;
+    return 1;
+}
+
+} // namespace
+
+int main() {
+    std::default_random_engine generator;
+    int failures = 0;
+
+    for (int len : {1, 2, 3, 4, 7, 8, 15, 16, 31, 64, 101}) {
+        std::vector<float> taps = randomValues((len + 1) / 2, generator);
+
+        // full registers of every width, with every tail length behind them
+        for (int count = 0; count <= 40; count++) {
+            std::vector<float> input = randomValues(count + len - 1, generator);
+            std::vector<std::complex<float>> complexInput(count + len - 1);
+            for (int i = 0; i < complexInput.size(); i++) {
+                complexInput[i] = std::complex<float>(input[i], input[input.size() - 1 - i]);
+            } // for
+
+            // one guard value past the end, which no kernel may write
+            std::vector<float> reference(count + 1, 7);
+            std::vector<std::complex<float>> complexReference(count + 1, 7);
+            Simd::setLevel(Simd::SCALAR);
+            Simd::symmetricFir(input.data(), taps.data(), len, reference.data(), count);
+            Simd::symmetricFir(complexInput.data(), taps.data(), len, complexReference.data(), count);
+            failures += check("real against a direct FIR", len, count, Simd::SCALAR,
+                relativeError(reference.data(), directFir(input, taps, len, count).data(), count));
+
+            for (int l = Simd::SSE2; l <= Simd::AVX512; l++) {
+                Simd::Level level = (Simd::Level) l;
+                Simd::setLevel(level);
+
+                std::vector<float> output(count + 1, 7);
+                std::vector<std::complex<float>> complexOutput(count + 1, 7);
+                Simd::symmetricFir(input.data(), taps.data(), len, output.data(), count);
+                Simd::symmetricFir(complexInput.data(), taps.data(), len, complexOutput.data(), count);
+
+                failures += check("real", len, count, level, relativeError(output.data(), reference.data(), count + 1));
+                failures += check("complex", len, count, level,
+                    relativeError((float*) complexOutput.data(), (float*) complexReference.data(), 2 * (count + 1)));
+            } // for
+        } // for
+    } // for
+
+    cout << (failures == 0 ? "all levels match" : "levels differ") << endl;
+    return failures == 0 ? 0 : 1;
+}
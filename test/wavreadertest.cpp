@@ -0,0 +1,300 @@
+// Checks WavReader on WAV, RF64 and extensible files built byte by byte, and that bad headers throw
+
+#include <iostream>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <unistd.h>
+#include "simd.h"
+#include "wavreader.h"
+
+using namespace std;
+
+namespace {
+
+std::string path;
+
+void putU16(std::string &bytes, unsigned int v) {
+    bytes += (char) (v & 0xFF);
+    bytes += (char) (v >> 8 & 0xFF);
+}
+
+void putU32(std::string &bytes, unsigned int v) {
+    putU16(bytes, v & 0xFFFF);
+    putU16(bytes, v >> 16);
+}
+
+void putU64(std::string &bytes, unsigned long long v) {
+    putU32(bytes, (unsigned int) v);
+    putU32(bytes, (unsigned int) (v >> 32));
+}
+
+void putChunk(std::string &bytes, const char *id, const std::string &body, unsigned int size) {
+    bytes.append(id, 4);
+    putU32(bytes, size);
+    bytes += body;
+    if (body.size() & 1) {
+        bytes += '\0';
+    } // if
+}
+
+void putChunk(std::string &bytes, const char *id, const std::string &body) {
+    putChunk(bytes, id, body, body.size());
+}
+
+struct Layout {
+    int formatTag;
+    int bits;
+    int channels;
+    bool extensible;
+    bool rf64;
+    // a chunk ahead of fmt, of odd length so it is padded
+    bool extra;
+};
+
+// a file of the layout around the given sample bytes
+std::string build(const Layout &layout, const std::string &samples) {
+    std::string fmt;
+    putU16(fmt, layout.extensible ? 0xFFFE : layout.formatTag);
+    putU16(fmt, layout.channels);
+    putU32(fmt, 44100);
+    putU32(fmt, 44100 * layout.channels * layout.bits / 8);
+    putU16(fmt, layout.channels * layout.bits / 8);
+    putU16(fmt, layout.bits);
+    if (layout.extensible) {
+        putU16(fmt, 22);
+        putU16(fmt, layout.bits);
+        putU32(fmt, 0);
+        putU16(fmt, layout.formatTag);
+        fmt.append("\x00\x00\x00\x00\x10\x00\x80\x00\x00\xAA\x00\x38\x9B\x71", 14);
+    } // if
+
+    std::string body = "WAVE";
+    if (layout.rf64) {
+        std::string ds64;
+        putU64(ds64, 0);
+        putU64(ds64, samples.size());
+        putU64(ds64, 0);
+        putU32(ds64, 0);
+        putChunk(body, "ds64", ds64);
+    } // if
+    if (layout.extra) {
+        putChunk(body, "LIST", "INFOx");
+    } // if
+    putChunk(body, "fmt ", fmt);
+    putChunk(body, "data", samples, layout.rf64 ? 0xFFFFFFFF : samples.size());
+
+    std::string bytes = layout.rf64 ? "RF64" : "RIFF";
+    putU32(bytes, layout.rf64 ? 0xFFFFFFFF : body.size());
+    return bytes + body;
+}
+
+void write(const std::string &bytes) {
+    std::ofstream file(path.c_str(), std::ios::binary | std::ios::trunc);
+    file.write(bytes.data(), bytes.size());
+}
+
+bool throws(const std::string &bytes) {
+    write(bytes);
+    try {
+        WavReader reader(path);
+    } catch (const std::invalid_argument &) {
+        return true;
+    } // catch
+
+    return false;
+}
+
+int check(const char *name, bool passed) {
+    if (passed) {
+        return 0;
+    } // if
+
+    cout << "FAIL " << name << endl;
+    return 1;
+}
+
+// random samples of a format, and the floats they convert to
+void randomSamples(WavReader::Format format, int count, std::default_random_engine &generator,
+    std::string &bytes, std::vector<float> &expected) {
+    std::uniform_int_distribution<int32_t> distribution(INT32_MIN, INT32_MAX);
+    for (int i = 0; i < count; i++) {
+        int32_t v = distribution(generator);
+        switch (format) {
+            case WavReader::PCM_INT16:
+                putU16(bytes, (uint32_t) v >> 16);
+                expected.push_back((v >> 16) / 32768.0f);
+                break;
+            case WavReader::PCM_INT24:
+                putU16(bytes, (uint32_t) v >> 8 & 0xFFFF);
+                bytes += (char) ((uint32_t) v >> 24);
+                expected.push_back((v >> 8) / 8388608.0f);
+                break;
+            case WavReader::PCM_INT32:
+                putU32(bytes, v);
+                expected.push_back(v / 2147483648.0f);
+                break;
+            case WavReader::FLOAT32: {
+                float f = (v >> 8) / 8388608.0f;
+                uint32_t u;
+                memcpy(&u, &f, 4);
+                putU32(bytes, u);
+                expected.push_back(f);
+                break;
+            }
+        } // switch
+    } // for
+}
+
+int checkSamples(std::default_random_engine &generator) {
+    int failures = 0;
+
+    struct Case {
+        WavReader::Format format;
+        Layout layout;
+    };
+    const Case cases[] = {
+        {WavReader::PCM_INT16, {1, 16, 1, false, false, false}},
+        {WavReader::PCM_INT16, {1, 16, 2, false, false, true}},
+        {WavReader::PCM_INT16, {1, 16, 3, true, true, false}},
+        {WavReader::PCM_INT24, {1, 24, 2, false, false, true}},
+        {WavReader::PCM_INT32, {1, 32, 2, true, false, false}},
+        {WavReader::FLOAT32, {3, 32, 1, false, true, false}},
+        {WavReader::FLOAT32, {3, 32, 2, true, false, true}},
+        {WavReader::FLOAT32, {3, 32, 5, false, false, false}}
+    };
+
+    // frame counts about the widths of the registers, and odd read lengths
+    const int frameCounts[] = {1, 7, 33, 1000};
+    const int readLens[] = {1, 5, 17, 64};
+
+    for (const Case &c : cases) {
+        for (int frames : frameCounts) {
+            std::string samples;
+            std::vector<float> expected;
+            randomSamples(c.format, frames * c.layout.channels, generator, samples, expected);
+            write(build(c.layout, samples));
+
+            for (int l = Simd::SCALAR; l <= Simd::AVX512; l++) {
+                Simd::setLevel((Simd::Level) l);
+                WavReader reader(path);
+                failures += check("header fields", reader.getFormat() == c.format
+                    && reader.getChannels() == c.layout.channels && reader.getSamplingFreq() == 44100
+                    && reader.getFrameCount() == frames);
+
+                // all channels, interleaved
+                std::vector<float> interleaved;
+                for (int i = 0; reader.getPosition() < frames; i++) {
+                    std::vector<float> block(readLens[i % 4] * c.layout.channels);
+                    int read = reader.read(&block[0], readLens[i % 4]);
+                    interleaved.insert(interleaved.end(), block.begin(), block.begin() + read * c.layout.channels);
+                } // for
+                failures += check("interleaved samples", interleaved == expected);
+
+                // each channel on its own
+                for (int channel = 0; channel < c.layout.channels; channel++) {
+                    reader.seek(0);
+                    std::vector<float> single(frames + 1);
+                    int read = reader.readChannel(&single[0], frames + 1, channel);
+                    bool same = read == frames;
+                    for (int f = 0; same && f < frames; f++) {
+                        same = single[f] == expected[f * c.layout.channels + channel];
+                    } // for
+                    failures += check("channel samples", same);
+                } // for
+            } // for
+            Simd::setLevel(Simd::detectLevel());
+        } // for
+    } // for
+
+    return failures;
+}
+
+int checkHeaders() {
+    int failures = 0;
+
+    Layout pcm = {1, 16, 2, false, false, true};
+    std::string samples(400, '\x11');
+    std::string good = build(pcm, samples);
+    std::string header = good.substr(0, good.size() - samples.size());
+
+    // every cut within the header throws, and every cut in the data keeps
+    // to the whole frames that are left
+    for (int len = 0; len < header.size(); len++) {
+        failures += check("truncated header", throws(good.substr(0, len)));
+    } // for
+    for (int len = header.size(); len <= good.size(); len+=3) {
+        write(good.substr(0, len));
+        WavReader reader(path);
+        failures += check("truncated data", reader.getFrameCount() == (len - (int) header.size()) / 4);
+    } // for
+
+    // not RIFF or WAVE, no data, data before fmt, and formats that cannot be read
+    failures += check("garbage", throws(std::string(100, '\xA5')));
+    std::string notWave = good;
+    notWave[11] = 'X';
+    failures += check("not WAVE", throws(notWave));
+    failures += check("no data", throws(good.substr(0, 12) + good.substr(12, header.size() - 20)));
+    std::string dataFirst = good.substr(0, 12);
+    putChunk(dataFirst, "data", samples);
+    failures += check("data before fmt", throws(dataFirst + good.substr(12)));
+    failures += check("8 bit PCM", throws(build({1, 8, 2, false, false, false}, samples)));
+    failures += check("24 bit float", throws(build({3, 24, 2, false, false, false}, samples)));
+    failures += check("no channels", throws(build({1, 16, 0, false, false, false}, samples)));
+
+    // a chunk running far past the end hides the data after it
+    std::string huge = good.substr(0, 12);
+    putChunk(huge, "junk", "", 0xFFFFFFF0);
+    failures += check("huge chunk", throws(huge + good.substr(12)));
+
+    // a data size past the end, in the data chunk or in ds64, keeps to the file
+    Layout rf64 = {1, 16, 2, false, true, false};
+    std::string big = build(rf64, samples);
+    size_t ds64Data = 12 + 8 + 8;
+    for (int b = 0; b < 8; b++) {
+        big[ds64Data + b] = '\xFF';
+    } // for
+    write(big);
+    WavReader pastEnd(path);
+    failures += check("ds64 size past the end", pastEnd.getFrameCount() == samples.size() / 4);
+
+    std::string streamed = good;
+    size_t dataSize = header.size() - 4;
+    for (int b = 0; b < 4; b++) {
+        streamed[dataSize + b] = '\xFF';
+    } // for
+    write(streamed);
+    WavReader unset(path);
+    failures += check("unset data size", unset.getFrameCount() == samples.size() / 4);
+
+    return failures;
+}
+
+} // namespace
+
+int main() {
+    char name[] = "/tmp/wavreadertestXXXXXX";
+    int fd = mkstemp(name);
+    if (fd < 0) {
+        cout << "FAIL cannot create a temporary file" << endl;
+        return 1;
+    } // if
+    close(fd);
+    path = name;
+
+    std::default_random_engine generator;
+    int failures = 0;
+
+    failures += checkSamples(generator);
+    failures += checkHeaders();
+
+    std::remove(name);
+
+    cout << (failures == 0 ? "all files match" : "files differ") << endl;
+    return failures == 0 ? 0 : 1;
+}